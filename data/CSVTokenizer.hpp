@@ -0,0 +1,127 @@
+#ifndef CSVTOKENIZER_HPP
+#define CSVTOKENIZER_HPP
+
+#include <string>
+#include <string_view>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Splits CSV lines into fields.
+// Candidate characters (the first character of the separator and quotes) are compared 32 bytes (AVX2)
+// or 16 bytes (SSE2) at a time into a bit mask, and only the set bits are inspected one by one.
+// Without SSE2 a plain scalar loop is used. Pick the instruction set at compile time (e.g, -mavx2).
+class CSVTokenizer
+{
+    private:
+        // portable count trailing zeros for the movemask results
+        static int first_set_bit(unsigned int mask)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(mask);
+#else
+            int index = 0;
+            while ((mask & 1) == 0) { mask >>= 1; index += 1; }
+            return index;
+#endif
+        }
+
+    public:
+        // call on_field(field_index, field_text) for every field of a line.
+        // Separators inside double quotes are ignored (quotes are kept in the field text),
+        // a trailing separator produces an empty last field and an empty line has no fields.
+        template <typename Callback>
+        static size_t for_each_field(std::string_view line, std::string_view sep, Callback &&on_field)
+        {
+            if (line.empty() || sep.empty())
+            {
+                if (!line.empty()) { on_field(0, line); return 1; }
+                return 0;
+            }
+
+            const char *line_begin = line.data();
+            const char *line_end = line.data() + line.size();
+            const char *field_begin = line_begin;
+            // positions before this one belong to a separator that was already consumed
+            const char *next_allowed = line_begin;
+            bool inside_string = false;
+            size_t field_index = 0;
+
+            // inspect one candidate position (a quote or the first character of the separator)
+            auto handle_candidate = [&](const char *current)
+            {
+                if (current < next_allowed) { return; }
+
+                if (!inside_string
+                    && *current == sep[0]
+                    && (size_t)(line_end - current) >= sep.size()
+                    && std::memcmp(current, sep.data(), sep.size()) == 0)
+                {
+                    on_field(field_index, std::string_view(field_begin, current - field_begin));
+                    field_index += 1;
+                    field_begin = current + sep.size();
+                    next_allowed = field_begin;
+                }
+                // check if we're inside quotes
+                else if (*current == '\"')
+                {
+                    inside_string = !inside_string;
+                }
+            };
+
+            // every candidate of a block is handled from one comparison mask
+            const char *block = line_begin;
+#if defined(__AVX2__)
+            const __m256i match_sep = _mm256_set1_epi8(sep[0]);
+            const __m256i match_quote = _mm256_set1_epi8('\"');
+            for (; line_end - block >= 32; block += 32)
+            {
+                __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+                unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chars, match_sep), _mm256_cmpeq_epi8(chars, match_quote)));
+                while (mask != 0)
+                {
+                    handle_candidate(block + first_set_bit(mask));
+                    mask &= mask - 1;
+                }
+            }
+#endif
+#if defined(__SSE2__)
+            const __m128i match_sep16 = _mm_set1_epi8(sep[0]);
+            const __m128i match_quote16 = _mm_set1_epi8('\"');
+            for (; line_end - block >= 16; block += 16)
+            {
+                __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+                unsigned int mask = (unsigned int)_mm_movemask_epi8(
+                    _mm_or_si128(_mm_cmpeq_epi8(chars, match_sep16), _mm_cmpeq_epi8(chars, match_quote16)));
+                while (mask != 0)
+                {
+                    handle_candidate(block + first_set_bit(mask));
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            // scalar tail (or everything without SSE2)
+            for (; block < line_end; ++block)
+            {
+                if (*block == sep[0] || *block == '\"') { handle_candidate(block); }
+            }
+
+            // last field runs to the end of the line
+            on_field(field_index, std::string_view(field_begin, line_end - field_begin));
+
+            return field_index + 1;
+        }
+
+        // number of fields in a line
+        static size_t count_fields(std::string_view line, std::string_view sep)
+        {
+            return for_each_field(line, sep, [](size_t, std::string_view) {});
+        }
+};
+
+#endif
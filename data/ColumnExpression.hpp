@@ -0,0 +1,427 @@
+#ifndef COLUMNEXPRESSION_HPP
+#define COLUMNEXPRESSION_HPP
+
+#include <vector>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Span.hpp"
+
+// Lazy arithmetic on numeric DataSet columns (expression templates).
+// Operators and functions on columns don't compute anything, they build a small tree of types that
+// describes the computation. Assigning the tree to a column evaluates every cell in one loop, so
+// ds.expr("a") * ds.expr("b") + 2.0 reads a and b once and makes no temporary column for a * b.
+// The loop fills blocks of BLOCK cells on the stack, which the compiler can vectorize when the columns
+// are contiguous (column-major data sets; row-major columns are read with a stride).
+// A result cell is null when any cell it was computed from is null.
+// NOTE: an expression points into the data sets of its columns and is only valid until they are resized or destroyed.
+//
+//     mydata.assign("ratio", mydata.expr("a") / mydata.expr("b"));
+//     mydata.assign("score", clip(log(mydata.expr("income")) * 2.0, 0.0, 20.0));
+//     mydata.assign("c", where(mydata.expr("a") > 0, mydata.expr("a"), 0.0));
+template <class E>
+class ColumnExpression
+{
+    public:
+        // cells computed per block of the evaluation loop (2KB of doubles, stays in L1 cache)
+        static constexpr size_t BLOCK = 256;
+
+    private:
+        template <bool Contiguous, class Value>
+        void fill_block(size_t first, size_t count, Value *block) const
+        {
+            E const& expression = this->self();
+            if (count == BLOCK)
+            {
+                // a fixed trip count, so the loop can be vectorized without a remainder
+                for (size_t k = 0; k < BLOCK; ++k)
+                {
+                    block[k] = expression.template at<Contiguous>(first + k);
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < count; ++k)
+                {
+                    block[k] = expression.template at<Contiguous>(first + k);
+                }
+            }
+        }
+
+    public:
+        E const& self() const
+        {
+            return static_cast<E const&>(*this);
+        }
+
+        // evaluate the first n cells into target[0], target[stride], ..., target[(n - 1) * stride].
+        // Cell i is only computed from the cells i of its columns, so target may be one of them
+        template <class Out>
+        void evaluate_into(Out *target, size_t n, size_t stride = 1) const
+        {
+            using Value = typename E::value_type;
+            Value block[BLOCK];
+            bool contiguous = this->self().is_contiguous();
+
+            for (size_t first = 0; first < n; first += BLOCK)
+            {
+                size_t count = std::min(BLOCK, n - first);
+                if (contiguous) { fill_block<true>(first, count, block); }
+                else { fill_block<false>(first, count, block); }
+
+                Out *out = target + first * stride;
+                for (size_t k = 0; k < count; ++k)
+                {
+                    out[k * stride] = static_cast<Out>(block[k]);
+                }
+            }
+        }
+
+        // the expression as a new vector of n cells
+        auto evaluate(size_t n) const
+        {
+            std::vector<typename E::value_type> values(n);
+            evaluate_into(values.data(), n);
+            return values;
+        }
+
+        // validity bitmap (1 = valid) of n result cells: the AND of the bitmaps of every column in the
+        // expression. Empty when none of them has null cells
+        std::vector<uint64_t> validity(size_t n) const
+        {
+            std::vector<uint64_t> bits;
+            this->self().for_each_validity([&](const uint64_t *words, size_t n_words)
+            {
+                if (bits.empty()) { bits.assign((n + 63) / 64, ~(uint64_t)0); }
+                for (size_t w = 0; w < std::min(n_words, bits.size()); ++w)
+                {
+                    bits[w] &= words[w];
+                }
+            });
+
+            return bits;
+        }
+};
+
+template <class X>
+inline constexpr bool is_column_expression_v = std::is_base_of_v<ColumnExpression<X>, X>;
+
+// a column of a data set (see DataSet::expr)
+template <class T>
+class ColumnLeaf : public ColumnExpression<ColumnLeaf<T>>
+{
+    private:
+        const T *first = nullptr;
+        size_t count = 0;
+        size_t stride = 1;
+
+        // validity bitmap of the column (nullptr without null cells)
+        const uint64_t *valid_words = nullptr;
+        size_t n_valid_words = 0;
+
+    public:
+        using value_type = T;
+
+        ColumnLeaf(Span<const T> cells, std::vector<uint64_t> const* validity)
+            : first{cells.data()}, count{cells.size()}, stride{cells.get_stride()}
+        {
+            if (validity != nullptr && !validity->empty())
+            {
+                valid_words = validity->data();
+                n_valid_words = validity->size();
+            }
+        }
+
+        template <bool Contiguous>
+        T at(size_t i) const
+        {
+            if constexpr (Contiguous) { return first[i]; }
+            else { return first[i * stride]; }
+        }
+
+        size_t size() const { return count; }
+        bool is_contiguous() const { return stride == 1; }
+
+        template <class F>
+        void for_each_validity(F f) const
+        {
+            if (valid_words != nullptr) { f(valid_words, n_valid_words); }
+        }
+};
+
+// size() of expressions without columns, which match columns of any size
+inline constexpr size_t ANY_COLUMN_SIZE = static_cast<size_t>(-1);
+
+// a number used for every row
+template <class T>
+class ColumnConstant : public ColumnExpression<ColumnConstant<T>>
+{
+    private:
+        T value;
+
+    public:
+        using value_type = T;
+
+        explicit ColumnConstant(T value) : value{value} {}
+
+        template <bool Contiguous>
+        T at(size_t) const { return value; }
+
+        size_t size() const { return ANY_COLUMN_SIZE; }
+        bool is_contiguous() const { return true; }
+
+        template <class F>
+        void for_each_validity(F) const {}
+};
+
+// number of rows of the operands of a node, which need to agree (constants fit any)
+inline size_t column_expression_size(size_t first, size_t second)
+{
+    if (first == ANY_COLUMN_SIZE) { return second; }
+    if (second == ANY_COLUMN_SIZE) { return first; }
+    if (first != second)
+    {
+        throw std::invalid_argument("Columns in an expression need the same number of rows ("
+            + std::to_string(first) + " and " + std::to_string(second) + ").");
+    }
+
+    return first;
+}
+
+// function(cell) for every cell of an expression
+template <class E, class F>
+class ColumnUnary : public ColumnExpression<ColumnUnary<E, F>>
+{
+    private:
+        E operand;
+        F function;
+
+    public:
+        using value_type = decltype(std::declval<F>()(std::declval<typename E::value_type>()));
+
+        ColumnUnary(E operand, F function) : operand{std::move(operand)}, function{std::move(function)} {}
+
+        template <bool Contiguous>
+        value_type at(size_t i) const { return function(operand.template at<Contiguous>(i)); }
+
+        size_t size() const { return operand.size(); }
+        bool is_contiguous() const { return operand.is_contiguous(); }
+
+        template <class G>
+        void for_each_validity(G g) const { operand.for_each_validity(g); }
+};
+
+// F::apply(left cell, right cell) for every row
+template <class L, class R, class F>
+class ColumnBinary : public ColumnExpression<ColumnBinary<L, R, F>>
+{
+    private:
+        L left;
+        R right;
+        size_t count;
+
+    public:
+        using value_type = decltype(F::apply(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()));
+
+        ColumnBinary(L left, R right)
+            : left{std::move(left)}, right{std::move(right)}, count{column_expression_size(this->left.size(), this->right.size())} {}
+
+        template <bool Contiguous>
+        value_type at(size_t i) const { return F::apply(left.template at<Contiguous>(i), right.template at<Contiguous>(i)); }
+
+        size_t size() const { return count; }
+        bool is_contiguous() const { return left.is_contiguous() && right.is_contiguous(); }
+
+        template <class G>
+        void for_each_validity(G g) const
+        {
+            left.for_each_validity(g);
+            right.for_each_validity(g);
+        }
+};
+
+// condition ? if_true : if_false for every row (both sides are computed, there are no branches)
+template <class C, class A, class B>
+class ColumnWhere : public ColumnExpression<ColumnWhere<C, A, B>>
+{
+    private:
+        C condition;
+        A if_true;
+        B if_false;
+        size_t count;
+
+    public:
+        using value_type = std::common_type_t<typename A::value_type, typename B::value_type>;
+
+        ColumnWhere(C condition, A if_true, B if_false)
+            : condition{std::move(condition)}, if_true{std::move(if_true)}, if_false{std::move(if_false)},
+              count{column_expression_size(this->condition.size(), column_expression_size(this->if_true.size(), this->if_false.size()))} {}
+
+        template <bool Contiguous>
+        value_type at(size_t i) const
+        {
+            value_type a = if_true.template at<Contiguous>(i);
+            value_type b = if_false.template at<Contiguous>(i);
+            return condition.template at<Contiguous>(i) ? a : b;
+        }
+
+        size_t size() const { return count; }
+        bool is_contiguous() const { return condition.is_contiguous() && if_true.is_contiguous() && if_false.is_contiguous(); }
+
+        template <class G>
+        void for_each_validity(G g) const
+        {
+            condition.for_each_validity(g);
+            if_true.for_each_validity(g);
+            if_false.for_each_validity(g);
+        }
+};
+
+// the operations of the nodes
+class ColumnOp
+{
+    public:
+        struct Add { template <class A, class B> static auto apply(A a, B b) { return a + b; } };
+        struct Subtract { template <class A, class B> static auto apply(A a, B b) { return a - b; } };
+        struct Multiply { template <class A, class B> static auto apply(A a, B b) { return a * b; } };
+        struct Divide { template <class A, class B> static auto apply(A a, B b) { return a / b; } };
+        struct Less { template <class A, class B> static bool apply(A a, B b) { return a < b; } };
+        struct LessEqual { template <class A, class B> static bool apply(A a, B b) { return a <= b; } };
+        struct Greater { template <class A, class B> static bool apply(A a, B b) { return a > b; } };
+        struct GreaterEqual { template <class A, class B> static bool apply(A a, B b) { return a >= b; } };
+        struct Equal { template <class A, class B> static bool apply(A a, B b) { return a == b; } };
+        struct NotEqual { template <class A, class B> static bool apply(A a, B b) { return a != b; } };
+        struct And { template <class A, class B> static bool apply(A a, B b) { return (bool)a & (bool)b; } };
+        struct Or { template <class A, class B> static bool apply(A a, B b) { return (bool)a | (bool)b; } };
+
+        struct Negate { template <class A> auto operator()(A a) const { return -a; } };
+        struct Not { template <class A> bool operator()(A a) const { return !a; } };
+        struct Log { template <class A> auto operator()(A a) const { return std::log(a); } };
+        struct Exp { template <class A> auto operator()(A a) const { return std::exp(a); } };
+        struct Sqrt { template <class A> auto operator()(A a) const { return std::sqrt(a); } };
+        struct Abs { template <class A> auto operator()(A a) const { return a < 0 ? -a : a; } };
+
+        struct Pow
+        {
+            double exponent;
+            template <class A> auto operator()(A a) const { return std::pow(a, exponent); }
+        };
+
+        template <class V>
+        struct Clip
+        {
+            V lower, upper;
+            V operator()(V a) const { return a < lower ? lower : (a > upper ? upper : a); }
+        };
+};
+
+// operands of the operators: at least one expression, the other one an expression or a number
+template <class L, class R>
+inline constexpr bool is_column_operands_v = (is_column_expression_v<L> || is_column_expression_v<R>)
+    && (is_column_expression_v<L> || std::is_arithmetic_v<L>)
+    && (is_column_expression_v<R> || std::is_arithmetic_v<R>);
+
+// numbers become constants, expressions stay as they are
+template <class X>
+auto column_operand(X const& operand)
+{
+    if constexpr (is_column_expression_v<X>) { return operand; }
+    else { return ColumnConstant<X>(operand); }
+}
+
+template <class F, class L, class R>
+auto column_binary(L const& left, R const& right)
+{
+    using Left = decltype(column_operand(left));
+    using Right = decltype(column_operand(right));
+    return ColumnBinary<Left, Right, F>(column_operand(left), column_operand(right));
+}
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator+(L const& left, R const& right) { return column_binary<ColumnOp::Add>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator-(L const& left, R const& right) { return column_binary<ColumnOp::Subtract>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator*(L const& left, R const& right) { return column_binary<ColumnOp::Multiply>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator/(L const& left, R const& right) { return column_binary<ColumnOp::Divide>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator<(L const& left, R const& right) { return column_binary<ColumnOp::Less>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator<=(L const& left, R const& right) { return column_binary<ColumnOp::LessEqual>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator>(L const& left, R const& right) { return column_binary<ColumnOp::Greater>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator>=(L const& left, R const& right) { return column_binary<ColumnOp::GreaterEqual>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator==(L const& left, R const& right) { return column_binary<ColumnOp::Equal>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator!=(L const& left, R const& right) { return column_binary<ColumnOp::NotEqual>(left, right); }
+
+// both sides are always computed (no short circuit)
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator&&(L const& left, R const& right) { return column_binary<ColumnOp::And>(left, right); }
+
+template <class L, class R, typename = std::enable_if_t<is_column_operands_v<L, R>>>
+auto operator||(L const& left, R const& right) { return column_binary<ColumnOp::Or>(left, right); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto operator-(E const& operand) { return ColumnUnary<E, ColumnOp::Negate>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto operator!(E const& operand) { return ColumnUnary<E, ColumnOp::Not>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto log(E const& operand) { return ColumnUnary<E, ColumnOp::Log>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto exp(E const& operand) { return ColumnUnary<E, ColumnOp::Exp>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto sqrt(E const& operand) { return ColumnUnary<E, ColumnOp::Sqrt>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto abs(E const& operand) { return ColumnUnary<E, ColumnOp::Abs>(operand, {}); }
+
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto pow(E const& operand, double exponent) { return ColumnUnary<E, ColumnOp::Pow>(operand, {exponent}); }
+
+// limit the cells to [lower, upper]
+template <class E, typename = std::enable_if_t<is_column_expression_v<E>>>
+auto clip(E const& operand, typename E::value_type lower, typename E::value_type upper)
+{
+    if (lower > upper)
+    {
+        throw std::invalid_argument("The lower bound of clip() can't be greater than the upper bound.");
+    }
+
+    using Clip = ColumnOp::Clip<typename E::value_type>;
+    return ColumnUnary<E, Clip>(operand, Clip{lower, upper});
+}
+
+// if_true where condition holds, if_false elsewhere (either can be a number)
+template <class C, class A, class B, typename = std::enable_if_t<is_column_expression_v<C>
+    && (is_column_expression_v<A> || std::is_arithmetic_v<A>) && (is_column_expression_v<B> || std::is_arithmetic_v<B>)>>
+auto where(C const& condition, A const& if_true, B const& if_false)
+{
+    using True = decltype(column_operand(if_true));
+    using False = decltype(column_operand(if_false));
+    return ColumnWhere<C, True, False>(condition, column_operand(if_true), column_operand(if_false));
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef DATAARENA_HPP
+#define DATAARENA_HPP
+
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define DATAARENA_USE_HUGE_PAGES 1
+#endif
+#endif
+
+// Memory resource for large buffers backed by transparent huge pages (2MB pages on x86-64, so a buffer
+// of a few hundred MB needs a few hundred TLB entries instead of ~100k).
+// Allocations of at least min_bytes are mapped on their own, aligned to a huge page and marked with
+// madvise(MADV_HUGEPAGE), smaller ones go to upstream. The kernel still decides whether huge pages are
+// used (/sys/kernel/mm/transparent_hugepage/enabled has to be "madvise" or "always").
+// Without Linux huge page support every allocation goes to upstream.
+//
+//     DataSet<double> big(rows, columns, Layout::RowMajor, HugePageResource::get());
+class HugePageResource : public std::pmr::memory_resource
+{
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+    private:
+        size_t min_bytes;
+        std::pmr::memory_resource *upstream;
+
+        static size_t round_up(size_t bytes)
+        {
+            return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        }
+
+        bool is_mapped(size_t bytes, size_t alignment) const
+        {
+#ifdef DATAARENA_USE_HUGE_PAGES
+            return bytes >= min_bytes && alignment <= HUGE_PAGE_SIZE;
+#else
+            (void)bytes;
+            (void)alignment;
+            return false;
+#endif
+        }
+
+    public:
+        explicit HugePageResource(size_t min_bytes = HUGE_PAGE_SIZE,
+                                  std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+            : min_bytes{min_bytes}, upstream{upstream} {}
+
+        // shared instance with the default settings (it keeps no state, so any thread can use it)
+        static HugePageResource *get()
+        {
+            static HugePageResource resource;
+            return &resource;
+        }
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+#ifdef DATAARENA_USE_HUGE_PAGES
+            if (is_mapped(bytes, alignment))
+            {
+                // map one huge page more than needed, then unmap the slack around the first huge page boundary
+                size_t length = round_up(bytes);
+                void *mapping = ::mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapping == MAP_FAILED)
+                {
+                    throw std::bad_alloc();
+                }
+
+                uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+                uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+                if (aligned > start)
+                {
+                    ::munmap(mapping, aligned - start);
+                }
+                size_t tail = (start + length + HUGE_PAGE_SIZE) - (aligned + length);
+                if (tail > 0)
+                {
+                    ::munmap(reinterpret_cast<void *>(aligned + length), tail);
+                }
+
+                ::madvise(reinterpret_cast<void *>(aligned), length, MADV_HUGEPAGE);
+                return reinterpret_cast<void *>(aligned);
+            }
+#endif
+            return upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *pointer, size_t bytes, size_t alignment) override
+        {
+#ifdef DATAARENA_USE_HUGE_PAGES
+            if (is_mapped(bytes, alignment))
+            {
+                ::munmap(pointer, round_up(bytes));
+                return;
+            }
+#endif
+            upstream->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+        {
+            return this == &other;
+        }
+};
+
+// Memory for the short-lived data of one job (e.g, the temporaries of a model fit).
+// Small allocations come from pools of equally sized blocks that are reused once freed, and
+// everything goes back in one shot when the arena is released or destroyed. Blocks larger than
+// the pools (e.g, a copy of the training data) are passed to the heap, or to HugePageResource
+// with huge_pages = true. Not thread safe: use one arena per thread.
+// NOTE: nothing allocated from an arena may outlive it. Copies of an arena DataSet use the default
+// heap, but a DataSet that is moved keeps pointing into the arena.
+//
+//     DataArena arena;
+//     DataSet<double> scratch(rows, columns, Layout::ColumnMajor, arena.resource());
+//     std::pmr::vector<size_t> indices(arena.resource());
+class DataArena
+{
+    private:
+        // largest block served from the pools, anything larger goes upstream
+        static constexpr size_t LARGEST_POOL_BLOCK = 1 << 16;
+
+        std::pmr::unsynchronized_pool_resource pool;
+
+        static std::pmr::pool_options arena_options()
+        {
+            std::pmr::pool_options options;
+            options.largest_required_pool_block = LARGEST_POOL_BLOCK;
+            return options;
+        }
+
+    public:
+        explicit DataArena(bool huge_pages = false)
+            : pool(arena_options(), huge_pages ? static_cast<std::pmr::memory_resource *>(HugePageResource::get())
+                                               : std::pmr::new_delete_resource()) {}
+
+        // the pools own their memory
+        DataArena(DataArena const&) = delete;
+        DataArena &operator=(DataArena const&) = delete;
+
+        std::pmr::memory_resource *resource()
+        {
+            return &pool;
+        }
+
+        // free everything that was allocated from the arena at once
+        void release()
+        {
+            pool.release();
+        }
+};
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef DATABUFFER_HPP
+#define DATABUFFER_HPP
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <memory_resource>
+
+// Storage behind a DataSet. Works like the std::vector it replaces, but can also point at memory
+// owned by someone else (e.g, a memory mapped binary file) without copying it.
+// External memory is kept alive through keep_alive and is copied into an owned vector as soon as
+// the buffer changes size or the buffer itself is copied, so DataSets keep their value semantics.
+// Owned elements come from a std::pmr::memory_resource (the default heap unless one is passed, e.g,
+// a DataArena). Copies always use the default resource, moves keep the resource of the source.
+template <class T>
+class DataBuffer
+{
+    private:
+        std::pmr::vector<T> owned;
+
+        // points to owned.data() or to the external memory
+        T *begin_ptr = nullptr;
+        size_t element_count = 0;
+
+        // non-null while the buffer views external memory
+        std::shared_ptr<const void> keep_alive;
+
+        void sync_owned()
+        {
+            begin_ptr = owned.data();
+            element_count = owned.size();
+        }
+
+        // take a private copy of external memory before changing it
+        void materialize()
+        {
+            if (keep_alive != nullptr)
+            {
+                owned.assign(begin_ptr, begin_ptr + element_count);
+                keep_alive.reset();
+                sync_owned();
+            }
+        }
+
+    public:
+        DataBuffer() {}
+
+        explicit DataBuffer(std::pmr::memory_resource *resource) : owned(std::pmr::polymorphic_allocator<T>(resource)) {}
+
+        DataBuffer(DataBuffer const& other)
+        {
+            owned.assign(other.begin_ptr, other.begin_ptr + other.element_count);
+            sync_owned();
+        }
+
+        DataBuffer(DataBuffer &&other) noexcept
+            : owned{std::move(other.owned)}, begin_ptr{other.begin_ptr},
+              element_count{other.element_count}, keep_alive{std::move(other.keep_alive)}
+        {
+            other.begin_ptr = nullptr;
+            other.element_count = 0;
+        }
+
+        // the copy goes into the memory resource of this buffer
+        DataBuffer &operator=(DataBuffer const& other)
+        {
+            if (this != &other)
+            {
+                keep_alive.reset();
+                owned.assign(other.begin_ptr, other.begin_ptr + other.element_count);
+                sync_owned();
+            }
+            return *this;
+        }
+
+        DataBuffer &operator=(DataBuffer &&other) noexcept
+        {
+            if (this != &other)
+            {
+                // buffers with different memory resources move element by element, so owned
+                // elements have to be looked up again after the move
+                owned = std::move(other.owned);
+                keep_alive = std::move(other.keep_alive);
+                if (keep_alive != nullptr)
+                {
+                    begin_ptr = other.begin_ptr;
+                    element_count = other.element_count;
+                }
+                else
+                {
+                    sync_owned();
+                }
+                other.owned.clear();
+                other.begin_ptr = nullptr;
+                other.element_count = 0;
+            }
+            return *this;
+        }
+
+        // view count elements at external without copying them.
+        // owner must keep the memory valid (and writable, for non-const access) while it's referenced
+        void adopt(T *external, size_t count, std::shared_ptr<const void> owner)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can view external memory.");
+
+            owned.clear();
+            owned.shrink_to_fit();
+            begin_ptr = external;
+            element_count = count;
+            keep_alive = std::move(owner);
+        }
+
+        // true while the elements live in external memory
+        bool is_external() const
+        {
+            return keep_alive != nullptr;
+        }
+
+        T &operator[](size_t i)
+        {
+            return begin_ptr[i];
+        }
+
+        T const& operator[](size_t i) const
+        {
+            return begin_ptr[i];
+        }
+
+        T *data() { return begin_ptr; }
+        T const *data() const { return begin_ptr; }
+
+        T *begin() { return begin_ptr; }
+        T *end() { return begin_ptr + element_count; }
+        T const *begin() const { return begin_ptr; }
+        T const *end() const { return begin_ptr + element_count; }
+
+        size_t size() const
+        {
+            return element_count;
+        }
+
+        std::pmr::memory_resource *get_resource() const
+        {
+            return owned.get_allocator().resource();
+        }
+
+        size_t capacity() const
+        {
+            return keep_alive != nullptr ? element_count : owned.capacity();
+        }
+
+        void resize(size_t count)
+        {
+            materialize();
+            owned.resize(count);
+            sync_owned();
+        }
+
+        void reserve(size_t count)
+        {
+            materialize();
+            owned.reserve(count);
+            sync_owned();
+        }
+
+        void clear()
+        {
+            keep_alive.reset();
+            owned.clear();
+            sync_owned();
+        }
+
+        void shrink_to_fit()
+        {
+            if (keep_alive == nullptr)
+            {
+                owned.shrink_to_fit();
+                sync_owned();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef DATASETREADER_HPP
+#define DATASETREADER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DataSet.hpp"
+
+// Reads a CSV file in batches of batch_size rows instead of loading it all at once,
+// so files larger than memory can be processed (e.g, for mini-batch training).
+// A background thread parses up to read_ahead batches ahead of the caller, memory use
+// stays at roughly (read_ahead + 1) batches no matter how large the file is.
+//
+//     DataSetReader<double> reader("big_file.csv", 10000);
+//     DataSet<double> batch;
+//     while (reader.next(batch)) { ... }
+template <class T>
+class DataSetReader
+{
+    static_assert(!std::is_same_v<T, std::string_view>,
+        "DataSetReader reuses its line buffer, use std::string (or DataSet<std::string_view> with load_mmap()) instead.");
+
+    private:
+        std::ifstream datafile;
+        std::string sep;
+        size_t batch_size;
+        size_t read_ahead;
+
+        std::vector<std::string> column_names;
+        size_t columns = 0;
+
+        // with has_headers = false the first line is read in the constructor to count columns
+        std::string pending_line;
+        bool has_pending_line = false;
+
+        // batches parsed by the background thread, waiting for next()
+        std::deque<DataSet<T>> ready_batches;
+        std::mutex batches_mutex;
+        std::condition_variable batches_changed;
+        bool finished = false;
+        bool stop_requested = false;
+        std::exception_ptr reader_error;
+        size_t total_rows = 0;
+
+        std::thread worker;
+
+        bool next_line(std::string &line)
+        {
+            if (has_pending_line)
+            {
+                line = pending_line;
+                has_pending_line = false;
+                return true;
+            }
+
+            return (bool)getline(datafile, line);
+        }
+
+        // background thread: parse batches until the file ends or the reader is destroyed
+        void read_batches()
+        {
+            try
+            {
+                std::string current_line;
+                size_t parsed_rows = 0;
+                while (true)
+                {
+                    DataSet<T> batch(batch_size, columns);
+                    batch.set_column_names(column_names);
+
+                    size_t batch_rows = 0;
+                    try
+                    {
+                        while (batch_rows < batch_size && next_line(current_line))
+                        {
+                            batch.split(current_line, batch_rows, sep);
+                            batch_rows += 1;
+                        }
+                    }
+                    // conversion errors name the row inside the batch, add where the batch starts
+                    catch (std::invalid_argument const& e)
+                    {
+                        throw std::invalid_argument("In the batch starting at row " + std::to_string(parsed_rows) + ": " + e.what());
+                    }
+                    catch (std::out_of_range const& e)
+                    {
+                        throw std::out_of_range("In the batch starting at row " + std::to_string(parsed_rows) + ": " + e.what());
+                    }
+                    parsed_rows += batch_rows;
+
+                    if (batch_rows == 0) { break; }
+
+                    // the last batch is usually smaller
+                    if (batch_rows < batch_size) { batch.resize(batch_rows, columns); }
+
+                    std::unique_lock<std::mutex> lock(batches_mutex);
+                    batches_changed.wait(lock, [this]() { return ready_batches.size() < read_ahead || stop_requested; });
+                    if (stop_requested) { return; }
+
+                    ready_batches.push_back(std::move(batch));
+                    batches_changed.notify_all();
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(batches_mutex);
+                reader_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(batches_mutex);
+            finished = true;
+            batches_changed.notify_all();
+        }
+
+    public:
+        DataSetReader(std::string filepath, size_t batch_size = 10000, std::string sep = ",", bool has_headers = true, size_t read_ahead = 2)
+            : sep{sep}, batch_size{batch_size}, read_ahead{read_ahead}
+        {
+            if (batch_size < 1) { throw std::invalid_argument("batch_size must be at least one."); }
+            if (read_ahead < 1) { throw std::invalid_argument("read_ahead must be at least one."); }
+
+            datafile.open(filepath, std::ios::in | std::ios::binary);
+
+            // check if file exists
+            if (datafile.fail())
+            {
+                throw std::runtime_error("There was a problem loading your data!\nCheck your directory/filename.");
+            }
+
+            // column names/count come from the first line, the same way load() gets them
+            std::string first_line;
+            if (getline(datafile, first_line))
+            {
+                DataSet<T> header;
+                if (has_headers)
+                {
+                    header.split(first_line, this->sep);
+                    this->column_names = header.column_names;
+                    this->columns = this->column_names.size();
+                }
+                else
+                {
+                    this->columns = header.count_columns_from_file(first_line, this->sep);
+                    this->pending_line = first_line;
+                    this->has_pending_line = true;
+                }
+            }
+
+            worker = std::thread(&DataSetReader::read_batches, this);
+        }
+
+        // the reader owns a thread and an open file
+        DataSetReader(DataSetReader const&) = delete;
+        DataSetReader &operator=(DataSetReader const&) = delete;
+
+        ~DataSetReader()
+        {
+            {
+                std::lock_guard<std::mutex> lock(batches_mutex);
+                stop_requested = true;
+            }
+            batches_changed.notify_all();
+
+            if (worker.joinable()) { worker.join(); }
+        }
+
+        // move the next batch into batch. Returns false once the whole file has been read.
+        // Parsing errors from the background thread are rethrown here.
+        bool next(DataSet<T> &batch)
+        {
+            std::unique_lock<std::mutex> lock(batches_mutex);
+            batches_changed.wait(lock, [this]() { return !ready_batches.empty() || finished; });
+
+            if (!ready_batches.empty())
+            {
+                batch = std::move(ready_batches.front());
+                ready_batches.pop_front();
+                total_rows += batch.count_rows();
+                batches_changed.notify_all();
+                return true;
+            }
+
+            if (reader_error) { std::rethrow_exception(reader_error); }
+
+            return false;
+        }
+
+        std::vector<std::string> get_column_names()
+        {
+            return column_names;
+        }
+
+        size_t count_columns()
+        {
+            return columns;
+        }
+
+        // rows handed out by next() so far
+        size_t rows_read()
+        {
+            return total_rows;
+        }
+};
+
+#endif
@@ -0,0 +1,403 @@
+#ifndef DATASETVIEW_HPP
+#define DATASETVIEW_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdlib>
+#include <ctime>
+
+#include "DataSet.hpp"
+
+// A non-owning window into a DataSet: a list of rows and a list of columns of a parent data set.
+// Selecting, dropping or filtering a view only builds index lists (O(indices) instead of O(cells)),
+// cells are read from the parent until materialize() copies them into a new DataSet.
+// Every model takes views in fit()/predict(), and a DataSet converts to a view of all its cells.
+// NOTE: the parent must outlive the view (a temporary data set is moved into the view instead),
+// and writes through a view change the parent.
+//
+//     DataSetView<double> features = DataSetView<double>(mydata).drop({"target"});
+//     model.fit(features, target);
+template <class T>
+class DataSetView
+{
+    private:
+        DataSet<T> *parent = nullptr;
+
+        // set when the view was built from a temporary data set, which it then keeps alive
+        // (shared by every view derived from it)
+        std::shared_ptr<DataSet<T>> owned_parent;
+
+        // parent indices in view order, nullptr selects every row/column of the parent.
+        // Subsetting one axis shares the index list of the other one
+        std::shared_ptr<const std::vector<size_t>> row_indices;
+        std::shared_ptr<const std::vector<size_t>> column_indices;
+        size_t rows = 0, columns = 0;
+
+        DataSetView(DataSetView<T> const& source, std::shared_ptr<const std::vector<size_t>> row_indices,
+                    std::shared_ptr<const std::vector<size_t>> column_indices)
+            : parent{source.parent}, owned_parent{source.owned_parent},
+              row_indices{std::move(row_indices)}, column_indices{std::move(column_indices)}
+        {
+            this->rows = this->row_indices != nullptr ? this->row_indices->size() : parent->count_rows();
+            this->columns = this->column_indices != nullptr ? this->column_indices->size() : parent->count_columns();
+        }
+
+        // translate indices of this view into parent indices
+        static std::shared_ptr<const std::vector<size_t>> compose(std::shared_ptr<const std::vector<size_t>> const& current,
+                                                                  std::vector<size_t> const& indices, size_t size, const char *axis)
+        {
+            std::vector<size_t> parent_indices(indices.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                if (indices[i] >= size)
+                {
+                    throw std::out_of_range("Index " + std::to_string(indices[i]) + " is out of range for a view with "
+                        + std::to_string(size) + " " + axis + ".");
+                }
+                parent_indices[i] = current != nullptr ? (*current)[indices[i]] : indices[i];
+            }
+
+            return std::make_shared<const std::vector<size_t>>(std::move(parent_indices));
+        }
+
+        // every index of the view except the dropped ones, in order
+        static std::vector<size_t> complement(std::vector<size_t> const& dropped, size_t size)
+        {
+            std::vector<bool> is_dropped(size, false);
+            for (size_t index : dropped)
+            {
+                if (index >= size)
+                {
+                    throw std::out_of_range("Index " + std::to_string(index) + " is out of range for a view with "
+                        + std::to_string(size) + " columns.");
+                }
+                is_dropped[index] = true;
+            }
+
+            std::vector<size_t> kept;
+            kept.reserve(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (!is_dropped[i]) { kept.push_back(i); }
+            }
+
+            return kept;
+        }
+
+    public:
+        DataSetView() {}
+
+        // view every cell of a data set
+        DataSetView(DataSet<T> &parent)
+            : parent{&parent}, rows{parent.count_rows()}, columns{parent.count_columns()} {}
+
+        // view every cell of a temporary data set (e.g, model.fit(mydata.select<double>(...), y)),
+        // the data set is moved into the view so it lives as long as the view
+        DataSetView(DataSet<T> &&parent)
+            : owned_parent{std::make_shared<DataSet<T>>(std::move(parent))}
+        {
+            this->parent = this->owned_parent.get();
+            this->rows = this->parent->count_rows();
+            this->columns = this->parent->count_columns();
+        }
+
+        // view the given rows and columns of a data set (in that order)
+        DataSetView(DataSet<T> &parent, std::vector<size_t> const& row_indices, std::vector<size_t> const& column_indices)
+            : DataSetView(parent)
+        {
+            this->row_indices = compose(nullptr, row_indices, this->rows, "rows");
+            this->column_indices = compose(nullptr, column_indices, this->columns, "columns");
+            this->rows = row_indices.size();
+            this->columns = column_indices.size();
+        }
+
+        size_t count_rows() const
+        {
+            return rows;
+        }
+
+        size_t count_columns() const
+        {
+            return columns;
+        }
+
+        DataSet<T> &get_parent() const
+        {
+            return *parent;
+        }
+
+        // the parent row/column behind a row/column of the view
+        size_t parent_row(size_t x) const
+        {
+            return row_indices != nullptr ? (*row_indices)[x] : x;
+        }
+
+        size_t parent_column(size_t y) const
+        {
+            return column_indices != nullptr ? (*column_indices)[y] : y;
+        }
+
+        // parent rows of the view, in view order
+        std::vector<size_t> get_row_indices() const
+        {
+            std::vector<size_t> indices(rows);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                indices[i] = parent_row(i);
+            }
+
+            return indices;
+        }
+
+        // a cell of the parent data set
+        T &operator()(size_t x, size_t y) const
+        {
+            return (*parent)(parent_row(x), parent_column(y));
+        }
+
+        bool is_null(size_t x, size_t y) const
+        {
+            return parent->is_null(parent_row(x), parent_column(y));
+        }
+
+        std::vector<T> get_row(size_t x) const
+        {
+            std::vector<T> return_vector(columns);
+            size_t source_row = parent_row(x);
+            for (size_t i = 0; i < columns; ++i)
+            {
+                return_vector[i] = (*parent)(source_row, parent_column(i));
+            }
+
+            return return_vector;
+        }
+
+        // row x as a span. It points into the parent when the view keeps every parent column in order,
+        // otherwise the cells are gathered into buffer, so reusing buffer keeps loops free of allocations
+        Span<const T> row_span(size_t x, std::vector<T> &buffer) const
+        {
+            if (column_indices == nullptr) { return parent->row_span(parent_row(x)); }
+
+            buffer.resize(columns);
+            size_t source_row = parent_row(x);
+            for (size_t i = 0; i < columns; ++i)
+            {
+                buffer[i] = (*parent)(source_row, (*column_indices)[i]);
+            }
+
+            return Span<const T>(buffer);
+        }
+
+        // column y as a span, strided over the parent when the view keeps every parent row in order
+        // (gathered into buffer otherwise)
+        Span<const T> column_span(size_t y, std::vector<T> &buffer) const
+        {
+            if (row_indices == nullptr) { return parent->column_span(parent_column(y)); }
+
+            buffer.resize(rows);
+            size_t source_column = parent_column(y);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                buffer[i] = (*parent)((*row_indices)[i], source_column);
+            }
+
+            return Span<const T>(buffer);
+        }
+
+        std::vector<T> get_column(size_t y) const
+        {
+            std::vector<T> return_vector(rows);
+            size_t source_column = parent_column(y);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                return_vector[i] = (*parent)(parent_row(i), source_column);
+            }
+
+            return return_vector;
+        }
+
+        // names of the viewed columns (empty if the parent has no column names)
+        std::vector<std::string> get_column_names() const
+        {
+            std::vector<std::string> names;
+            if (parent == nullptr || parent->column_names.empty()) { return names; }
+
+            names.reserve(columns);
+            for (size_t i = 0; i < columns; ++i)
+            {
+                names.push_back(parent->column_names[parent_column(i)]);
+            }
+
+            return names;
+        }
+
+        // positions of the given column names inside the view
+        std::vector<size_t> get_column_indices(std::vector<std::string> const& passed_columns) const
+        {
+            std::vector<std::string> names = this->get_column_names();
+            std::vector<size_t> col_idx;
+            for (std::string const& col_name : passed_columns)
+            {
+                auto it = std::find(names.begin(), names.end(), col_name);
+                if (it == names.end())
+                {
+                    throw std::invalid_argument("Column name '" + col_name + "' was not found.");
+                }
+                col_idx.push_back(it - names.begin());
+            }
+
+            return col_idx;
+        }
+
+        // rows of this view by index (duplicates are allowed, e.g, for bootstrapping)
+        DataSetView<T> get_rows(std::vector<size_t> const& indices) const
+        {
+            return DataSetView<T>(*this, compose(row_indices, indices, rows, "rows"), column_indices);
+        }
+
+        DataSetView<T> select(std::vector<size_t> const& indices) const
+        {
+            return DataSetView<T>(*this, row_indices, compose(column_indices, indices, columns, "columns"));
+        }
+
+        DataSetView<T> select(std::vector<std::string> const& indices) const
+        {
+            return select(get_column_indices(indices));
+        }
+
+        DataSetView<T> drop(std::vector<size_t> const& indices) const
+        {
+            return select(complement(indices, columns));
+        }
+
+        DataSetView<T> drop(std::vector<std::string> const& indices) const
+        {
+            return drop(get_column_indices(indices));
+        }
+
+        // rows for which filter_conditions returns true
+        DataSetView<T> filter(std::function<bool(std::vector<T>)> filter_conditions) const
+        {
+            std::vector<size_t> returned_rows;
+            for (size_t current_row = 0; current_row < rows; ++current_row)
+            {
+                if (filter_conditions(this->get_row(current_row)))
+                {
+                    returned_rows.push_back(current_row);
+                }
+            }
+
+            return get_rows(returned_rows);
+        }
+
+        // rows that match a filter expression (see FilterExpression.hpp), evaluated column by column
+        DataSetView<T> filter(FilterExpression const& condition) const
+        {
+            std::vector<T> buffer;
+            std::vector<uint64_t> selection = condition.select_rows<T>(rows,
+                [&](size_t y)
+                {
+                    if (y >= columns)
+                    {
+                        throw std::out_of_range("Index " + std::to_string(y) + " is out of range for a view with "
+                            + std::to_string(columns) + " columns.");
+                    }
+                    return this->column_span(y, buffer);
+                },
+                [&](size_t y, std::vector<uint64_t> &bits)
+                {
+                    size_t source_column = parent_column(y);
+                    if (source_column >= parent->validity.size() || parent->validity[source_column].empty()) { return; }
+                    for (size_t i = 0; i < rows; ++i)
+                    {
+                        if (!parent->cell_is_valid(parent_row(i), source_column)) { bits[i / 64] &= ~((uint64_t)1 << (i % 64)); }
+                    }
+                },
+                [&](std::string const& name) { return this->get_column_indices({name})[0]; });
+
+            std::vector<size_t> returned_rows;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                if ((selection[i / 64] >> (i % 64)) & 1) { returned_rows.push_back(i); }
+            }
+
+            return get_rows(returned_rows);
+        }
+
+        // randomly split the rows into "train/test" views, like DataSet::split_data()
+        void split_data(double test_ratio, DataSetView<T> &train, DataSetView<T> &test) const
+        {
+            if (test_ratio <= 0 || test_ratio >= 1)
+            {
+                throw std::invalid_argument("test_ratio parameter must be in interval (0, 1).");
+            }
+
+            // set random seed once, so calls within the same second still give different splits
+            static bool seeded = false;
+            if (!seeded)
+            {
+                srand(time(NULL));
+                seeded = true;
+            }
+
+            size_t test_size = (size_t)(test_ratio * rows);
+            std::vector<bool> in_test(rows, false);
+            std::vector<size_t> test_rows, train_rows;
+            test_rows.reserve(test_size);
+            train_rows.reserve(rows - test_size);
+
+            while (test_rows.size() < test_size)
+            {
+                size_t rand_index = rand() % rows;
+                if (!in_test[rand_index])
+                {
+                    in_test[rand_index] = true;
+                    test_rows.push_back(rand_index);
+                }
+            }
+
+            for (size_t i = 0; i < rows; ++i)
+            {
+                if (!in_test[i]) { train_rows.push_back(i); }
+            }
+
+            train = get_rows(train_rows);
+            test = get_rows(test_rows);
+        }
+
+        // copy the viewed cells (with their null values and column names) into a new data set,
+        // stored in the layout that suits how the copy will be read.
+        // Temporary copies can be allocated from a DataArena (resource must outlive the copy)
+        DataSet<T> materialize(Layout layout = Layout::RowMajor,
+                               std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const
+        {
+            DataSet<T> copy(rows, columns, layout, resource);
+            if (parent == nullptr) { return copy; }
+
+            parent->share_text_buffers(copy);
+            copy.set_column_names(this->get_column_names());
+
+            for (size_t x = 0; x < rows; ++x)
+            {
+                size_t source_row = parent_row(x);
+                for (size_t y = 0; y < columns; ++y)
+                {
+                    size_t source_column = parent_column(y);
+                    copy.data[copy.cell_index(x, y)] = parent->data[parent->cell_index(source_row, source_column)];
+                    if constexpr (!is_text_type_v<T>)
+                    {
+                        if (!parent->cell_is_valid(source_row, source_column)) { copy.mark_null(x, y); }
+                    }
+                }
+            }
+
+            return copy;
+        }
+};
+
+#endif
@@ -0,0 +1,586 @@
+#ifndef ENCODEDDATASET_HPP
+#define ENCODEDDATASET_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <type_traits>
+
+#include "DataSet.hpp"
+
+// Distinct values of one column. Every value is stored once and identified by its code,
+// code 0 is always the empty (null) value.
+class ColumnDictionary
+{
+    private:
+        // a deque never moves its elements, so the lookup keys can point into it
+        std::deque<std::string> values;
+        std::unordered_map<std::string_view, uint32_t> codes;
+
+        void rebuild_codes()
+        {
+            codes.clear();
+            codes.reserve(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                codes.emplace(values[i], (uint32_t)i);
+            }
+        }
+
+    public:
+        ColumnDictionary()
+        {
+            values.emplace_back();
+            rebuild_codes();
+        }
+
+        // copies need their own lookup keys, the copied ones point into other's values
+        ColumnDictionary(ColumnDictionary const& other) : values{other.values}
+        {
+            rebuild_codes();
+        }
+
+        ColumnDictionary &operator=(ColumnDictionary const& other)
+        {
+            if (this != &other)
+            {
+                values = other.values;
+                rebuild_codes();
+            }
+            return *this;
+        }
+
+        ColumnDictionary(ColumnDictionary &&other) = default;
+        ColumnDictionary &operator=(ColumnDictionary &&other) = default;
+
+        // code of text, adding it to the dictionary if it's new
+        uint32_t encode(std::string_view text)
+        {
+            auto found = codes.find(text);
+            if (found != codes.end())
+            {
+                return found->second;
+            }
+
+            if (values.size() == UINT32_MAX)
+            {
+                throw std::length_error("A column can't have more than 2^32 - 1 distinct values.");
+            }
+
+            values.emplace_back(text);
+            uint32_t code = (uint32_t)(values.size() - 1);
+            codes.emplace(values.back(), code);
+
+            return code;
+        }
+
+        // code of text, or UINT32_MAX if the dictionary doesn't have it
+        uint32_t find(std::string_view text) const
+        {
+            auto found = codes.find(text);
+            return found != codes.end() ? found->second : UINT32_MAX;
+        }
+
+        std::string const& decode(uint32_t code) const
+        {
+            return values[code];
+        }
+
+        // change the text of a code. new_text must not be in the dictionary yet
+        void rename(uint32_t code, std::string_view new_text)
+        {
+            codes.erase(values[code]);
+            values[code] = std::string(new_text);
+            codes.emplace(values[code], code);
+        }
+
+        size_t size() const
+        {
+            return values.size();
+        }
+};
+
+// Text data set that stores every distinct value of a column once, in a per-column dictionary,
+// and every cell as a 32 bit code into that dictionary. Columns with few distinct values
+// (categories) take a fraction of the memory of DataSet<std::string> and filter(), replace(),
+// replacena() and select() work on the codes: conditions are evaluated once per distinct value
+// and cells are compared as integers.
+// Empty cells (null values) have code 0 in every column.
+class EncodedDataSet
+{
+    private:
+        std::vector<uint32_t> codes;
+        std::vector<ColumnDictionary> dictionaries;
+        size_t rows = 0, columns = 0;
+
+        // output buffer size of to_csv(), the same as DataSet::to_csv()
+        static constexpr size_t CSV_BUFFER_SIZE = 1 << 20;
+
+        void check_column(size_t column)
+        {
+            if (column >= columns)
+            {
+                throw std::out_of_range("Column " + std::to_string(column) + " is out of range, the data set has "
+                    + std::to_string(columns) + " columns.");
+            }
+        }
+
+        // keep the rows where keep_row(row) is true
+        EncodedDataSet filter_rows(std::function<bool(size_t)> keep_row, bool inplace)
+        {
+            EncodedDataSet filtered_data;
+            filtered_data.column_names = this->column_names;
+            filtered_data.dictionaries = this->dictionaries;
+            filtered_data.columns = this->columns;
+
+            for (size_t row = 0; row < this->rows; ++row)
+            {
+                if (keep_row(row))
+                {
+                    filtered_data.codes.insert(filtered_data.codes.end(),
+                        this->codes.begin() + row * this->columns, this->codes.begin() + (row + 1) * this->columns);
+                    filtered_data.rows += 1;
+                }
+            }
+
+            if (inplace)
+            {
+                *this = filtered_data;
+            }
+
+            return filtered_data;
+        }
+
+    public:
+        std::vector<std::string> column_names;
+
+        EncodedDataSet() {}
+
+        // load data set when passing filename
+        EncodedDataSet(std::string filepath, std::string sep = ",", bool has_headers = true)
+        {
+            this->load(filepath, sep, has_headers);
+        }
+
+        // encode an existing text data set
+        explicit EncodedDataSet(DataSet<std::string> &text_data)
+        {
+            this->rows = text_data.count_rows();
+            this->columns = text_data.count_columns();
+            this->column_names = text_data.column_names;
+            this->dictionaries.assign(this->columns, ColumnDictionary());
+            this->codes.resize(this->rows * this->columns);
+
+            for (size_t row = 0; row < this->rows; ++row)
+            {
+                for (size_t col = 0; col < this->columns; ++col)
+                {
+                    this->codes[row * this->columns + col] = this->dictionaries[col].encode(text_data(row, col));
+                }
+            }
+        }
+
+        // load from file. Fields are encoded straight from the memory mapped file,
+        // only the first occurrence of every value is copied
+        void load(std::string filepath, std::string sep = ",", bool has_headers = true)
+        {
+            MappedFile file(filepath);
+            const char *current = file.data();
+            const char *file_end = file.data() + file.size();
+
+            this->column_names.clear();
+            this->dictionaries.clear();
+            this->codes.clear();
+            this->rows = 0;
+            this->columns = 0;
+
+            // next line with the same semantics as getline()
+            auto next_line = [&]()
+            {
+                const char *line_end = static_cast<const char *>(std::memchr(current, '\n', file_end - current));
+                if (line_end == nullptr) { line_end = file_end; }
+
+                std::string_view line(current, line_end - current);
+                current = line_end + 1;
+                return line;
+            };
+
+            if (current >= file_end) { return; }
+
+            // the first line holds the headers (or is used to count columns)
+            if (has_headers)
+            {
+                CSVTokenizer::for_each_field(next_line(), sep, [&](size_t, std::string_view field)
+                {
+                    this->column_names.push_back(std::string(field));
+                });
+
+                std::vector<std::string> unique_names = this->column_names;
+                std::sort(unique_names.begin(), unique_names.end());
+                if (std::unique(unique_names.begin(), unique_names.end()) != unique_names.end())
+                {
+                    throw std::runtime_error("Columns must be uniquely named when loading");
+                }
+                this->columns = this->column_names.size();
+            }
+            else
+            {
+                const char *first_line_start = current;
+                this->columns = CSVTokenizer::count_fields(next_line(), sep);
+                current = first_line_start;
+            }
+
+            this->dictionaries.assign(this->columns, ColumnDictionary());
+
+            // rows are counted up front so the codes are allocated once
+            if (current < file_end)
+            {
+                this->rows = std::count(current, file_end, '\n');
+                if (*(file_end - 1) != '\n') { this->rows += 1; }
+            }
+            this->codes.assign(this->rows * this->columns, 0);
+
+            for (size_t row = 0; row < this->rows; ++row)
+            {
+                CSVTokenizer::for_each_field(next_line(), sep, [&](size_t col, std::string_view field)
+                {
+                    // ignore any fields past the expected column count, like DataSet::load()
+                    if (col < this->columns)
+                    {
+                        this->codes[row * this->columns + col] = this->dictionaries[col].encode(field);
+                    }
+                });
+            }
+        }
+
+        size_t count_rows()
+        {
+            return rows;
+        }
+
+        size_t count_columns()
+        {
+            return columns;
+        }
+
+        // extract a cell from data
+        std::string const& operator()(size_t x, size_t y)
+        {
+            return dictionaries[y].decode(codes[x * columns + y]);
+        }
+
+        // set a value in the data, adding it to the column's dictionary if it's new
+        void set(size_t x, size_t y, std::string_view value)
+        {
+            codes[x * columns + y] = dictionaries[y].encode(value);
+        }
+
+        // dictionary code of a cell (0 for empty cells)
+        uint32_t get_code(size_t x, size_t y)
+        {
+            return codes[x * columns + y];
+        }
+
+        // number of distinct values ever stored in a column, including the empty value.
+        // Values that were replaced may still count until the data set is decoded and encoded again
+        size_t count_categories(size_t column)
+        {
+            check_column(column);
+            return dictionaries[column].size();
+        }
+
+        // text of a dictionary code of a column
+        std::string const& get_category(size_t column, uint32_t code)
+        {
+            check_column(column);
+            return dictionaries[column].decode(code);
+        }
+
+        std::vector<std::string> get_row(size_t x)
+        {
+            std::vector<std::string> return_vector(columns);
+            for (size_t i = 0; i < columns; ++i)
+            {
+                return_vector[i] = (*this)(x, i);
+            }
+
+            return return_vector;
+        }
+
+        std::vector<std::string> get_column(size_t y)
+        {
+            std::vector<std::string> return_vector(rows);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                return_vector[i] = (*this)(i, y);
+            }
+
+            return return_vector;
+        }
+
+        std::vector<size_t> get_column_indices(std::vector<std::string> const& passed_columns)
+        {
+            std::vector<size_t> column_indices;
+            for (std::string const& name : passed_columns)
+            {
+                auto found = std::find(column_names.begin(), column_names.end(), name);
+                if (found == column_names.end())
+                {
+                    throw std::invalid_argument("Column name '" + name + "' was not found.");
+                }
+                column_indices.push_back(found - column_names.begin());
+            }
+
+            return column_indices;
+        }
+
+        // expand the codes back into a text data set
+        DataSet<std::string> decode()
+        {
+            DataSet<std::string> decoded_data(rows, columns);
+            decoded_data.set_column_names(column_names);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    decoded_data(row, col) = (*this)(row, col);
+                }
+            }
+
+            return decoded_data;
+        }
+
+        // the dictionary codes as a numeric data set, with empty cells as null values.
+        // Numeric work keyed by text columns (e.g, DataSet::group_by()) can use the codes and
+        // translate them back with get_category()
+        template <class N = double>
+        DataSet<N> get_codes()
+        {
+            static_assert(std::is_arithmetic_v<N>, "Dictionary codes need a numeric data set.");
+
+            DataSet<N> code_data(rows, columns);
+            code_data.set_column_names(column_names);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    uint32_t code = codes[row * columns + col];
+                    if (code == 0) { code_data.set_null(row, col); }
+                    else { code_data.set(row, col, (N)code); }
+                }
+            }
+
+            return code_data;
+        }
+
+        // keep the rows whose value in column satisfies filter_condition.
+        // The condition is called once per distinct value of the column, not once per row
+        EncodedDataSet filter(size_t column, std::function<bool(std::string const&)> filter_condition, bool inplace = false)
+        {
+            check_column(column);
+
+            std::vector<char> keep_code(dictionaries[column].size());
+            for (size_t code = 0; code < keep_code.size(); ++code)
+            {
+                keep_code[code] = filter_condition(dictionaries[column].decode((uint32_t)code));
+            }
+
+            return filter_rows([&](size_t row) { return keep_code[codes[row * columns + column]] != 0; }, inplace);
+        }
+
+        EncodedDataSet filter(std::string column_name, std::function<bool(std::string const&)> filter_condition, bool inplace = false)
+        {
+            return filter(get_column_indices({column_name})[0], filter_condition, inplace);
+        }
+
+        // keep the rows where every listed column holds the given value (one integer compare per cell)
+        EncodedDataSet filter(std::unordered_map<std::string, std::string> const& equal_values, bool inplace = false)
+        {
+            std::vector<size_t> filter_columns;
+            std::vector<uint32_t> filter_codes;
+            for (auto const& column_value : equal_values)
+            {
+                size_t column = get_column_indices({column_value.first})[0];
+                filter_columns.push_back(column);
+                filter_codes.push_back(dictionaries[column].find(column_value.second));
+            }
+
+            return filter_rows([&](size_t row)
+            {
+                for (size_t i = 0; i < filter_columns.size(); ++i)
+                {
+                    if (codes[row * columns + filter_columns[i]] != filter_codes[i]) { return false; }
+                }
+                return true;
+            }, inplace);
+        }
+
+        // select columns by index (their dictionaries are copied along)
+        EncodedDataSet select(std::vector<size_t> const& indices, bool inplace = false)
+        {
+            EncodedDataSet subset;
+            subset.rows = this->rows;
+            subset.columns = indices.size();
+            subset.codes.resize(subset.rows * subset.columns);
+
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                check_column(indices[i]);
+                subset.dictionaries.push_back(this->dictionaries[indices[i]]);
+                if (!this->column_names.empty())
+                {
+                    subset.column_names.push_back(this->column_names[indices[i]]);
+                }
+            }
+
+            for (size_t row = 0; row < this->rows; ++row)
+            {
+                for (size_t i = 0; i < indices.size(); ++i)
+                {
+                    subset.codes[row * subset.columns + i] = this->codes[row * this->columns + indices[i]];
+                }
+            }
+
+            if (inplace)
+            {
+                *this = subset;
+            }
+
+            return subset;
+        }
+
+        EncodedDataSet select(std::vector<std::string> const& indices, bool inplace = false)
+        {
+            return select(get_column_indices(indices), inplace);
+        }
+
+        // replace arbitrary value in data set.
+        // Without an occurrence limit only the dictionaries change (the value is renamed),
+        // unless replace_value already exists in a column, then its cells are recoded
+        EncodedDataSet replace(std::string const& original_value, std::string const& replace_value, bool inplace = false, size_t occurences = 0)
+        {
+            if (!inplace)
+            {
+                EncodedDataSet modified_data = *this;
+                return modified_data.replace(original_value, replace_value, true, occurences);
+            }
+
+            if (original_value == replace_value) { return *this; }
+
+            std::vector<uint32_t> original_codes(columns), replace_codes(columns);
+            for (size_t col = 0; col < columns; ++col)
+            {
+                original_codes[col] = dictionaries[col].find(original_value);
+                if (original_codes[col] == UINT32_MAX) { continue; }
+
+                uint32_t existing_code = dictionaries[col].find(replace_value);
+                if (occurences == 0 && existing_code == UINT32_MAX && original_codes[col] != 0)
+                {
+                    // nothing to recode, the code just gets new text
+                    dictionaries[col].rename(original_codes[col], replace_value);
+                    original_codes[col] = UINT32_MAX;
+                }
+                else
+                {
+                    replace_codes[col] = dictionaries[col].encode(replace_value);
+                }
+            }
+
+            size_t occurence_counter = 0;
+            for (size_t row = 0; row < rows; ++row)
+            {
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    uint32_t &code = codes[row * columns + col];
+                    if (code == original_codes[col] && (occurences == 0 || occurence_counter < occurences))
+                    {
+                        code = replace_codes[col];
+                        occurence_counter += 1;
+                    }
+                }
+            }
+
+            return *this;
+        }
+
+        // replace null (empty) values
+        EncodedDataSet replacena(const std::string replace_text, bool inplace = false)
+        {
+            return replace("", replace_text, inplace);
+        }
+
+        // number of null (empty) values per column
+        std::vector<size_t> countna_vector()
+        {
+            std::vector<size_t> null_counts(columns, 0);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    null_counts[col] += codes[row * columns + col] == 0;
+                }
+            }
+
+            return null_counts;
+        }
+
+        // Write data set to CSV file with custom delimiter and optionally print headers.
+        // Every value is copied from its dictionary into a fixed size buffer
+        void to_csv(std::string file_name, std::string sep = ",", bool print_header = true)
+        {
+            std::ofstream ofile(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (ofile.fail())
+            {
+                throw std::runtime_error("Could not open '" + file_name + "' for writing.");
+            }
+
+            std::string write_buffer;
+            write_buffer.reserve(CSV_BUFFER_SIZE + 1024);
+
+            // write column names to CSV file (optional)
+            if (print_header && !this->column_names.empty())
+            {
+                for (size_t h = 0; h < columns; ++h)
+                {
+                    if (h != 0) { write_buffer += sep; }
+                    write_buffer += this->column_names[h];
+                }
+                write_buffer += "\n";
+            }
+
+            for (size_t row = 0; row < rows; ++row)
+            {
+                // don't add random breakline at end of file
+                if (row != 0) { write_buffer += '\n'; }
+
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    if (col != 0) { write_buffer += sep; }
+                    write_buffer += dictionaries[col].decode(codes[row * columns + col]);
+                }
+
+                if (write_buffer.size() >= CSV_BUFFER_SIZE)
+                {
+                    ofile.write(write_buffer.data(), write_buffer.size());
+                    write_buffer.clear();
+                }
+            }
+
+            ofile.write(write_buffer.data(), write_buffer.size());
+            ofile.close();
+
+            if (ofile.fail())
+            {
+                throw std::runtime_error("Could not write to '" + file_name + "'.");
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef FILTEREXPRESSION_HPP
+#define FILTEREXPRESSION_HPP
+
+#include <vector>
+#include <string>
+#include <initializer_list>
+#include <string_view>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <type_traits>
+
+#include "Span.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Row conditions for DataSet::filter() that are evaluated one column at a time instead of one row at a time.
+// Every comparison scans its column into a selection bitmap (one bit per row, 64 rows per word) and
+// AND/OR/NOT combine whole bitmaps, so no row is copied into a vector to be tested.
+// Contiguous double columns (column-major data sets, views gathered into a buffer) are compared 4 cells (AVX)
+// or 2 cells (SSE2) at a time, everything else with a scalar loop. Pick the instruction set at compile time.
+// Null cells never match a comparison (but do match its negation).
+//
+//     DataSet<double> adults = mydata.filter(FilterColumn::named("age") >= 18
+//                                            && FilterColumn::named("income").between(1000, 5000));
+//     DataSet<std::string> picked = names.filter(FilterColumn::named("city").in({"Paris", "Rome"})
+//                                                || !(FilterColumn::at(0) == "NA"));
+class FilterExpression
+{
+    public:
+        enum class Op { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+    private:
+        enum class Kind { Compare, Between, In, And, Or, Not };
+
+        Kind kind = Kind::Compare;
+        Op op = Op::Equal;
+
+        // the column is looked up by name unless column_name is empty
+        std::string column_name;
+        size_t column_index = 0;
+
+        // numeric constants compare with numeric data sets, text constants with text data sets
+        bool is_text = false;
+        std::vector<double> values;
+        std::vector<std::string> texts;
+
+        std::shared_ptr<const FilterExpression> left, right;
+
+        friend class FilterColumn;
+
+        template <class Value>
+        static bool test(Op op, Value const& cell, Value const& value)
+        {
+            switch (op)
+            {
+                case Op::Less: return cell < value;
+                case Op::LessEqual: return cell <= value;
+                case Op::Greater: return cell > value;
+                case Op::GreaterEqual: return cell >= value;
+                case Op::Equal: return cell == value;
+                case Op::NotEqual: return cell != value;
+            }
+            return false;
+        }
+
+        // set bit i of bits[i / 64] for every cell that passes is_kept (bits past the end stay 0)
+        template <class T, class Test>
+        static void scalar_bits(Span<const T> column, uint64_t *bits, Test is_kept)
+        {
+            size_t n = column.size();
+            for (size_t word = 0; word * 64 < n; ++word)
+            {
+                size_t first = word * 64;
+                size_t count = std::min<size_t>(64, n - first);
+                uint64_t mask = 0;
+                for (size_t b = 0; b < count; ++b)
+                {
+                    mask |= (uint64_t)(is_kept(column[first + b]) ? 1 : 0) << b;
+                }
+                bits[word] = mask;
+            }
+        }
+
+#if defined(__AVX__)
+        template <Op op>
+        static __m256d compare_lanes(__m256d cells, __m256d value)
+        {
+            if constexpr (op == Op::Less) { return _mm256_cmp_pd(cells, value, _CMP_LT_OQ); }
+            else if constexpr (op == Op::LessEqual) { return _mm256_cmp_pd(cells, value, _CMP_LE_OQ); }
+            else if constexpr (op == Op::Greater) { return _mm256_cmp_pd(cells, value, _CMP_GT_OQ); }
+            else if constexpr (op == Op::GreaterEqual) { return _mm256_cmp_pd(cells, value, _CMP_GE_OQ); }
+            else if constexpr (op == Op::Equal) { return _mm256_cmp_pd(cells, value, _CMP_EQ_OQ); }
+            else { return _mm256_cmp_pd(cells, value, _CMP_NEQ_UQ); }
+        }
+#elif defined(__SSE2__)
+        template <Op op>
+        static __m128d compare_lanes(__m128d cells, __m128d value)
+        {
+            if constexpr (op == Op::Less) { return _mm_cmplt_pd(cells, value); }
+            else if constexpr (op == Op::LessEqual) { return _mm_cmple_pd(cells, value); }
+            else if constexpr (op == Op::Greater) { return _mm_cmpgt_pd(cells, value); }
+            else if constexpr (op == Op::GreaterEqual) { return _mm_cmpge_pd(cells, value); }
+            else if constexpr (op == Op::Equal) { return _mm_cmpeq_pd(cells, value); }
+            else { return _mm_cmpneq_pd(cells, value); }
+        }
+#endif
+
+        // compare n contiguous doubles with lower (op_low) and, for ranges, upper (op_high) into bits
+        template <Op op_low, Op op_high, bool is_range>
+        static void double_bits(const double *cells, size_t n, uint64_t *bits, double lower, double upper)
+        {
+            size_t word = 0;
+#if defined(__AVX__)
+            const __m256d low = _mm256_set1_pd(lower), high = _mm256_set1_pd(upper);
+            for (; (word + 1) * 64 <= n; ++word)
+            {
+                const double *block = cells + word * 64;
+                uint64_t mask = 0;
+                for (size_t b = 0; b < 64; b += 4)
+                {
+                    __m256d lanes = _mm256_loadu_pd(block + b);
+                    __m256d kept = compare_lanes<op_low>(lanes, low);
+                    if constexpr (is_range) { kept = _mm256_and_pd(kept, compare_lanes<op_high>(lanes, high)); }
+                    mask |= (uint64_t)_mm256_movemask_pd(kept) << b;
+                }
+                bits[word] = mask;
+            }
+#elif defined(__SSE2__)
+            const __m128d low = _mm_set1_pd(lower), high = _mm_set1_pd(upper);
+            for (; (word + 1) * 64 <= n; ++word)
+            {
+                const double *block = cells + word * 64;
+                uint64_t mask = 0;
+                for (size_t b = 0; b < 64; b += 2)
+                {
+                    __m128d lanes = _mm_loadu_pd(block + b);
+                    __m128d kept = compare_lanes<op_low>(lanes, low);
+                    if constexpr (is_range) { kept = _mm_and_pd(kept, compare_lanes<op_high>(lanes, high)); }
+                    mask |= (uint64_t)_mm_movemask_pd(kept) << b;
+                }
+                bits[word] = mask;
+            }
+#endif
+            // the last partial word (or everything without SSE2)
+            size_t first = word * 64;
+            if (first < n)
+            {
+                scalar_bits(Span<const double>(cells + first, n - first), bits + word, [&](double cell)
+                {
+                    return test(op_low, cell, lower) && (!is_range || test(op_high, cell, upper));
+                });
+            }
+        }
+
+        template <Op op>
+        static void double_compare_bits(const double *cells, size_t n, uint64_t *bits, double value)
+        {
+            double_bits<op, op, false>(cells, n, bits, value, value);
+        }
+
+        static void double_compare_bits(Op op, const double *cells, size_t n, uint64_t *bits, double value)
+        {
+            switch (op)
+            {
+                case Op::Less: double_compare_bits<Op::Less>(cells, n, bits, value); break;
+                case Op::LessEqual: double_compare_bits<Op::LessEqual>(cells, n, bits, value); break;
+                case Op::Greater: double_compare_bits<Op::Greater>(cells, n, bits, value); break;
+                case Op::GreaterEqual: double_compare_bits<Op::GreaterEqual>(cells, n, bits, value); break;
+                case Op::Equal: double_compare_bits<Op::Equal>(cells, n, bits, value); break;
+                case Op::NotEqual: double_compare_bits<Op::NotEqual>(cells, n, bits, value); break;
+            }
+        }
+
+        template <class T>
+        void check_constant_type() const
+        {
+            constexpr bool text_data = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+            if (text_data && !is_text)
+            {
+                throw std::invalid_argument("Text columns can only be compared with text values.");
+            }
+            if (!text_data && is_text)
+            {
+                throw std::invalid_argument("Numeric columns can only be compared with numbers.");
+            }
+        }
+
+        // bits of the rows kept by a comparison, a range or an IN-list on one column
+        template <class T>
+        void column_bits(Span<const T> column, uint64_t *bits) const
+        {
+            check_constant_type<T>();
+            constexpr bool text_data = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+            size_t n = column.size();
+            size_t n_words = (n + 63) / 64;
+
+            if constexpr (text_data)
+            {
+                if (kind == Kind::Compare)
+                {
+                    std::string_view value = texts[0];
+                    scalar_bits(column, bits, [&](T const& cell) { return test(op, std::string_view(cell), value); });
+                }
+                else if (kind == Kind::Between)
+                {
+                    std::string_view lower = texts[0], upper = texts[1];
+                    scalar_bits(column, bits, [&](T const& cell) { return lower <= cell && std::string_view(cell) <= upper; });
+                }
+                else
+                {
+                    scalar_bits(column, bits, [&](T const& cell) { return std::binary_search(texts.begin(), texts.end(), cell); });
+                }
+            }
+            else if (kind == Kind::In && values.size() > 8)
+            {
+                // long lists are searched, short ones are ORed from equality scans below
+                scalar_bits(column, bits, [&](T cell) { return std::binary_search(values.begin(), values.end(), (double)cell); });
+            }
+            else if (kind == Kind::In)
+            {
+                std::fill(bits, bits + n_words, 0);
+                std::vector<uint64_t> matches(n_words);
+                for (double value : values)
+                {
+                    FilterExpression equal;
+                    equal.op = Op::Equal;
+                    equal.values = {value};
+                    equal.column_bits(column, matches.data());
+                    for (size_t w = 0; w < n_words; ++w) { bits[w] |= matches[w]; }
+                }
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                if (column.get_stride() == 1 && kind == Kind::Compare)
+                {
+                    double_compare_bits(op, column.data(), n, bits, values[0]);
+                    return;
+                }
+                if (column.get_stride() == 1)
+                {
+                    double_bits<Op::GreaterEqual, Op::LessEqual, true>(column.data(), n, bits, values[0], values[1]);
+                    return;
+                }
+                scalar_column_bits(column, bits);
+            }
+            else
+            {
+                scalar_column_bits(column, bits);
+            }
+        }
+
+        template <class T>
+        void scalar_column_bits(Span<const T> column, uint64_t *bits) const
+        {
+            double lower = values[0];
+            if (kind == Kind::Compare)
+            {
+                Op compare_op = op;
+                scalar_bits(column, bits, [&](T cell) { return test(compare_op, (double)cell, lower); });
+            }
+            else
+            {
+                double upper = values[1];
+                scalar_bits(column, bits, [&](T cell) { return lower <= (double)cell && (double)cell <= upper; });
+            }
+        }
+
+    public:
+        FilterExpression() {}
+
+        FilterExpression operator&&(FilterExpression const& other) const
+        {
+            return combine(Kind::And, other);
+        }
+
+        FilterExpression operator||(FilterExpression const& other) const
+        {
+            return combine(Kind::Or, other);
+        }
+
+        FilterExpression operator!() const
+        {
+            FilterExpression negated;
+            negated.kind = Kind::Not;
+            negated.left = std::make_shared<const FilterExpression>(*this);
+            return negated;
+        }
+
+        // selection bitmap of the rows that match (bit i of word i / 64 is row i, bits past rows are 0).
+        // column(y) returns column y as a span, mask_nulls(y, bits) clears the bits of null cells of
+        // column y and find_column(name) looks up a column index
+        template <class T, class GetColumn, class MaskNulls, class FindColumn>
+        std::vector<uint64_t> select_rows(size_t rows, GetColumn &&column, MaskNulls &&mask_nulls, FindColumn &&find_column) const
+        {
+            std::vector<uint64_t> bits((rows + 63) / 64);
+            if (kind == Kind::And || kind == Kind::Or)
+            {
+                bits = left->select_rows<T>(rows, column, mask_nulls, find_column);
+                std::vector<uint64_t> other = right->select_rows<T>(rows, column, mask_nulls, find_column);
+                for (size_t w = 0; w < bits.size(); ++w)
+                {
+                    bits[w] = kind == Kind::And ? bits[w] & other[w] : bits[w] | other[w];
+                }
+            }
+            else if (kind == Kind::Not)
+            {
+                bits = left->select_rows<T>(rows, column, mask_nulls, find_column);
+                for (uint64_t &word : bits) { word = ~word; }
+                if (rows % 64 != 0) { bits.back() &= ((uint64_t)1 << (rows % 64)) - 1; }
+            }
+            else
+            {
+                size_t y = column_name.empty() ? column_index : find_column(column_name);
+                Span<const T> cells = column(y);
+                column_bits(cells, bits.data());
+                mask_nulls(y, bits);
+            }
+
+            return bits;
+        }
+
+    private:
+        FilterExpression combine(Kind combined_kind, FilterExpression const& other) const
+        {
+            FilterExpression combined;
+            combined.kind = combined_kind;
+            combined.left = std::make_shared<const FilterExpression>(*this);
+            combined.right = std::make_shared<const FilterExpression>(other);
+            return combined;
+        }
+};
+
+// A column in a filter expression, by name or by index: FilterColumn::named("age") > 30.
+// Built with static factories rather than a free col() function, so the common name col stays free
+// for local variables and members
+class FilterColumn
+{
+    private:
+        std::string name;
+        size_t index = 0;
+
+        FilterExpression leaf() const
+        {
+            FilterExpression expression;
+            expression.column_name = name;
+            expression.column_index = index;
+            return expression;
+        }
+
+        FilterExpression compare(FilterExpression::Op op, double value) const
+        {
+            FilterExpression expression = leaf();
+            expression.op = op;
+            expression.values = {value};
+            return expression;
+        }
+
+        FilterExpression compare(FilterExpression::Op op, std::string value) const
+        {
+            FilterExpression expression = leaf();
+            expression.op = op;
+            expression.is_text = true;
+            expression.texts = {std::move(value)};
+            return expression;
+        }
+
+        explicit FilterColumn(std::string name) : name{std::move(name)}
+        {
+            if (this->name.empty())
+            {
+                throw std::invalid_argument("Filter columns need a name (or an index).");
+            }
+        }
+
+        explicit FilterColumn(size_t index) : index{index} {}
+
+    public:
+        static FilterColumn named(std::string name)
+        {
+            return FilterColumn(std::move(name));
+        }
+
+        static FilterColumn at(size_t index)
+        {
+            return FilterColumn(index);
+        }
+
+        FilterExpression operator<(double value) const { return compare(FilterExpression::Op::Less, value); }
+        FilterExpression operator<=(double value) const { return compare(FilterExpression::Op::LessEqual, value); }
+        FilterExpression operator>(double value) const { return compare(FilterExpression::Op::Greater, value); }
+        FilterExpression operator>=(double value) const { return compare(FilterExpression::Op::GreaterEqual, value); }
+        FilterExpression operator==(double value) const { return compare(FilterExpression::Op::Equal, value); }
+        FilterExpression operator!=(double value) const { return compare(FilterExpression::Op::NotEqual, value); }
+
+        FilterExpression operator<(std::string value) const { return compare(FilterExpression::Op::Less, std::move(value)); }
+        FilterExpression operator<=(std::string value) const { return compare(FilterExpression::Op::LessEqual, std::move(value)); }
+        FilterExpression operator>(std::string value) const { return compare(FilterExpression::Op::Greater, std::move(value)); }
+        FilterExpression operator>=(std::string value) const { return compare(FilterExpression::Op::GreaterEqual, std::move(value)); }
+        FilterExpression operator==(std::string value) const { return compare(FilterExpression::Op::Equal, std::move(value)); }
+        FilterExpression operator!=(std::string value) const { return compare(FilterExpression::Op::NotEqual, std::move(value)); }
+
+        // lower <= cell <= upper
+        FilterExpression between(double lower, double upper) const
+        {
+            FilterExpression expression = leaf();
+            expression.kind = FilterExpression::Kind::Between;
+            expression.values = {lower, upper};
+            return expression;
+        }
+
+        FilterExpression between(std::string lower, std::string upper) const
+        {
+            FilterExpression expression = leaf();
+            expression.kind = FilterExpression::Kind::Between;
+            expression.is_text = true;
+            expression.texts = {std::move(lower), std::move(upper)};
+            return expression;
+        }
+
+        // the cell equals one of the values
+        FilterExpression in(std::vector<double> values) const
+        {
+            FilterExpression expression = leaf();
+            expression.kind = FilterExpression::Kind::In;
+            std::sort(values.begin(), values.end());
+            expression.values = std::move(values);
+            return expression;
+        }
+
+        FilterExpression in(std::vector<std::string> values) const
+        {
+            FilterExpression expression = leaf();
+            expression.kind = FilterExpression::Kind::In;
+            expression.is_text = true;
+            std::sort(values.begin(), values.end());
+            expression.texts = std::move(values);
+            return expression;
+        }
+
+        // braced lists, so in({"a", "b"}) isn't read as a pair of iterators
+        FilterExpression in(std::initializer_list<double> values) const { return in(std::vector<double>(values)); }
+        FilterExpression in(std::initializer_list<std::string> values) const { return in(std::vector<std::string>(values)); }
+};
+
+#endif
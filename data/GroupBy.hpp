@@ -0,0 +1,421 @@
+#ifndef GROUPBY_HPP
+#define GROUPBY_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DataSet.hpp"
+#include "KeyHash.hpp"
+#include "Parallel.hpp"
+
+enum class Aggregation { Count, Sum, Mean, Min, Max, Var };
+
+// Groups the rows of a numeric data set by the values of key columns and aggregates other columns per group.
+// Rows are assigned to groups with an open-addressing hash table (linear probing, group keys stored
+// contiguously), then every aggregated column is scanned once to update the accumulators of its groups.
+// Large data sets are split into ranges of rows that are grouped on separate threads, and the partial
+// groups are merged at the end (variances with Chan's parallel update). A mean is always sum / count,
+// so it doesn't depend on which other aggregations are requested.
+// Groups are listed in the order they first appear. Rows with a null key are left out, and null values
+// are not aggregated: Count is the number of non-null values, and the mean, min and max of a group
+// without values are null (the sample variance needs two values).
+// Text keys can be grouped through their dictionary codes (see EncodedDataSet::get_codes()).
+//
+//     DataSet<double> stats = mydata.group_by({"store", "day"}).agg({{"sales", Aggregation::Sum},
+//                                                                   {"sales", Aggregation::Mean},
+//                                                                   {"price", Aggregation::Max}});
+template <class T>
+class GroupBy
+{
+    static_assert(std::is_arithmetic_v<T>, "group_by() needs a numeric data set (text keys can be encoded first).");
+
+    private:
+        static constexpr size_t NO_GROUP = std::numeric_limits<size_t>::max();
+
+        // rows per block of group_rows()
+        static constexpr size_t BLOCK = 1024;
+
+        struct Accumulator
+        {
+            size_t count = 0;
+            double sum = 0, mean = 0, m2 = 0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+        };
+
+        // the groups of a range of rows
+        struct Groups
+        {
+            // slot s of the hash table holds a group index + 1 (0 = empty slot). The table is kept at most a
+            // quarter full: with random keys every probe past the first slot is a mispredicted branch
+            std::vector<size_t> slots;
+            // per group: its hash, its key values (key_columns.size() each), its number of rows and
+            // its accumulators (one per aggregated column)
+            std::vector<uint64_t> hashes;
+            std::vector<T> keys;
+            std::vector<size_t> sizes;
+            std::vector<Accumulator> accumulators;
+        };
+
+        DataSet<T> const *data = nullptr;
+        std::vector<size_t> key_columns;
+
+        static bool same_key(T a, T b)
+        {
+            if constexpr (std::is_floating_point_v<T>) { return a == b || (a != a && b != b); }
+            else { return a == b; }
+        }
+
+        static bool is_valid(std::vector<uint64_t> const* bits, size_t row)
+        {
+            return bits == nullptr || row / 64 >= bits->size() || (((*bits)[row / 64] >> (row % 64)) & 1) != 0;
+        }
+
+        std::vector<uint64_t> const* column_validity(size_t y) const
+        {
+            if (y >= data->validity.size() || data->validity[y].empty()) { return nullptr; }
+            return &data->validity[y];
+        }
+
+        // double the hash table and put every group back into it
+        static void grow(Groups &groups)
+        {
+            size_t capacity = std::max<size_t>(1024, groups.slots.size() * 2);
+            groups.slots.assign(capacity, 0);
+            size_t mask = capacity - 1;
+            for (size_t g = 0; g < groups.hashes.size(); ++g)
+            {
+                size_t slot = groups.hashes[g] & mask;
+                while (groups.slots[slot] != 0) { slot = (slot + 1) & mask; }
+                groups.slots[slot] = g + 1;
+            }
+        }
+
+        // add a group with the keys key(0), key(1), ... and empty accumulators in the empty slot
+        template <class Key>
+        size_t add_group(Groups &groups, size_t slot, uint64_t hash, Key key, size_t n_values) const
+        {
+            size_t g = groups.hashes.size();
+            groups.slots[slot] = g + 1;
+            groups.hashes.push_back(hash);
+            for (size_t k = 0; k < key_columns.size(); ++k) { groups.keys.push_back(key(k)); }
+            groups.sizes.push_back(0);
+            groups.accumulators.resize(groups.accumulators.size() + n_values);
+            if (4 * groups.hashes.size() > groups.slots.size()) { grow(groups); }
+            return g;
+        }
+
+        // index of the group with the keys key(0), key(1), ..., added if it's new
+        template <class Key>
+        size_t find_or_add(Groups &groups, uint64_t hash, Key key, size_t n_values) const
+        {
+            size_t n_keys = key_columns.size();
+            size_t mask = groups.slots.size() - 1;
+            const size_t *slots = groups.slots.data();
+            const uint64_t *hashes = groups.hashes.data();
+            const T *keys = groups.keys.data();
+            for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                size_t entry = slots[slot];
+                if (entry == 0)
+                {
+                    return add_group(groups, slot, hash, key, n_values);
+                }
+
+                size_t g = entry - 1;
+                if (hashes[g] == hash)
+                {
+                    const T *group_keys = keys + g * n_keys;
+                    bool same = true;
+                    for (size_t k = 0; k < n_keys && same; ++k) { same = same_key(group_keys[k], key(k)); }
+                    if (same) { return g; }
+                }
+            }
+        }
+
+        template <bool NeedsVariance>
+        static void update(Accumulator &accumulator, double value)
+        {
+            accumulator.count += 1;
+            accumulator.sum += value;
+            accumulator.min = std::min(accumulator.min, value);
+            accumulator.max = std::max(accumulator.max, value);
+            if constexpr (NeedsVariance)
+            {
+                double delta = value - accumulator.mean;
+                accumulator.mean += delta / accumulator.count;
+                accumulator.m2 += delta * (value - accumulator.mean);
+            }
+        }
+
+        static void merge(Accumulator &into, Accumulator const& other)
+        {
+            if (other.count == 0) { return; }
+
+            size_t count = into.count + other.count;
+            double delta = other.mean - into.mean;
+            into.mean += delta * other.count / count;
+            into.m2 += other.m2 + delta * delta * ((double)into.count * other.count / count);
+            into.count = count;
+            into.sum += other.sum;
+            into.min = std::min(into.min, other.min);
+            into.max = std::max(into.max, other.max);
+        }
+
+        // group rows [first, last) and aggregate value_columns over them (and count the rows of every group with count_rows)
+        template <bool NeedsVariance>
+        Groups group_rows(size_t first, size_t last, std::vector<size_t> const& value_columns, bool count_rows) const
+        {
+            size_t n_keys = key_columns.size(), n_values = value_columns.size();
+            std::vector<Span<const T>> keys, value_spans;
+            std::vector<std::vector<uint64_t> const*> key_validity, value_validity;
+            for (size_t y : key_columns)
+            {
+                keys.push_back(data->column_span(y));
+                key_validity.push_back(column_validity(y));
+            }
+            for (size_t y : value_columns)
+            {
+                value_spans.push_back(data->column_span(y));
+                value_validity.push_back(column_validity(y));
+            }
+
+            Groups groups;
+            grow(groups);
+
+            // rows are handled in blocks that stay in L1 cache: hash the keys of the block column by column,
+            // find the group of every row, then update the accumulators one aggregated column at a time
+            bool has_key_nulls = std::any_of(key_validity.begin(), key_validity.end(), [](auto bits) { return bits != nullptr; });
+            uint64_t hashes[BLOCK];
+            size_t block_groups[BLOCK];
+            for (size_t block_first = first; block_first < last; block_first += BLOCK)
+            {
+                size_t count = std::min(BLOCK, last - block_first);
+                std::fill(hashes, hashes + count, 0x9e3779b97f4a7c15ULL);
+                for (size_t k = 0; k < n_keys; ++k)
+                {
+                    Span<const T> key = keys[k];
+                    for (size_t r = 0; r < count; ++r)
+                    {
+                        hashes[r] = KeyHash::mix(hashes[r] ^ KeyHash::key_bits(key[block_first + r]));
+                    }
+                }
+
+                for (size_t r = 0; r < count; ++r)
+                {
+                    size_t row = block_first + r;
+                    bool has_null_key = false;
+                    for (size_t k = 0; k < n_keys && has_key_nulls; ++k)
+                    {
+                        has_null_key = has_null_key || !is_valid(key_validity[k], row);
+                    }
+                    if (has_null_key)
+                    {
+                        block_groups[r] = NO_GROUP;
+                        continue;
+                    }
+
+                    block_groups[r] = find_or_add(groups, hashes[r], [&](size_t k) { return keys[k][row]; }, n_values);
+                }
+
+                // counted in a loop of its own, the increments would hold up the lookups above
+                if (count_rows)
+                {
+                    for (size_t r = 0; r < count; ++r)
+                    {
+                        if (block_groups[r] != NO_GROUP) { groups.sizes[block_groups[r]] += 1; }
+                    }
+                }
+
+                for (size_t j = 0; j < n_values; ++j)
+                {
+                    Span<const T> values = value_spans[j];
+                    std::vector<uint64_t> const* bits = value_validity[j];
+                    for (size_t r = 0; r < count; ++r)
+                    {
+                        size_t g = block_groups[r];
+                        if (g == NO_GROUP || !is_valid(bits, block_first + r)) { continue; }
+                        update<NeedsVariance>(groups.accumulators[g * n_values + j], (double)values[block_first + r]);
+                    }
+                }
+            }
+
+            return groups;
+        }
+
+        // add the groups (and accumulators) of other to into, keeping the order of first appearance
+        void merge_groups(Groups &into, Groups const& other, size_t n_values) const
+        {
+            size_t n_keys = key_columns.size();
+            for (size_t g = 0; g < other.hashes.size(); ++g)
+            {
+                const T *other_keys = other.keys.data() + g * n_keys;
+                size_t target = find_or_add(into, other.hashes[g], [&](size_t k) { return other_keys[k]; }, n_values);
+                into.sizes[target] += other.sizes[g];
+                for (size_t j = 0; j < n_values; ++j)
+                {
+                    merge(into.accumulators[target * n_values + j], other.accumulators[g * n_values + j]);
+                }
+            }
+        }
+
+        // group every row, in ranges of rows on up to n_threads threads (see Parallel.hpp),
+        // then merge the partial groups in range order
+        template <bool NeedsVariance>
+        Groups group(std::vector<size_t> const& value_columns, size_t n_threads, bool count_rows = false) const
+        {
+            size_t n_ranges = parallel_range_count(data->rows, n_threads);
+            std::vector<Groups> partial(n_ranges);
+            parallel_ranges(data->rows, n_ranges, [&](size_t range, size_t first, size_t last)
+            {
+                partial[range] = group_rows<NeedsVariance>(first, last, value_columns, count_rows);
+            });
+
+            for (size_t i = 1; i < n_ranges; ++i)
+            {
+                merge_groups(partial[0], partial[i], value_columns.size());
+            }
+
+            return std::move(partial[0]);
+        }
+
+        // a data set with one row per group, starting with the key columns
+        DataSet<double> key_table(Groups const& groups, std::vector<std::string> names, size_t extra_columns) const
+        {
+            size_t n_keys = key_columns.size(), n_groups = groups.hashes.size();
+            DataSet<double> result(n_groups, n_keys + extra_columns);
+            for (size_t k = n_keys; k-- > 0;)
+            {
+                size_t y = key_columns[k];
+                names.insert(names.begin(), y < data->column_names.size() ? data->column_names[y] : "col" + std::to_string(y));
+            }
+            result.set_column_names(names);
+
+            for (size_t g = 0; g < n_groups; ++g)
+            {
+                for (size_t k = 0; k < n_keys; ++k)
+                {
+                    result.set(g, k, (double)groups.keys[g * n_keys + k]);
+                }
+            }
+
+            return result;
+        }
+
+        static std::string aggregation_name(Aggregation aggregation)
+        {
+            switch (aggregation)
+            {
+                case Aggregation::Count: return "count";
+                case Aggregation::Sum: return "sum";
+                case Aggregation::Mean: return "mean";
+                case Aggregation::Min: return "min";
+                case Aggregation::Max: return "max";
+                case Aggregation::Var: return "var";
+            }
+            return "";
+        }
+
+    public:
+        GroupBy(DataSet<T> const& data, std::vector<size_t> key_columns) : data{&data}, key_columns{std::move(key_columns)}
+        {
+            if (this->key_columns.empty())
+            {
+                throw std::invalid_argument("group_by() needs at least one key column.");
+            }
+            for (size_t y : this->key_columns)
+            {
+                if (y >= data.columns)
+                {
+                    throw std::out_of_range("Column " + std::to_string(y) + " is out of range for a data set with "
+                        + std::to_string(data.columns) + " columns.");
+                }
+            }
+        }
+
+        // one row per group: the key columns, then one column per aggregation named "<column>_<aggregation>"
+        // (e.g, "sales_mean"). Large data sets are grouped on n_threads threads (0 uses every hardware thread)
+        DataSet<double> agg(std::vector<std::pair<std::string, Aggregation>> const& aggregations, size_t n_threads = 0) const
+        {
+            // every aggregated column is scanned once, however many aggregations use it
+            std::vector<size_t> value_columns, aggregation_values;
+            bool needs_variance = false;
+            for (auto const& [name, aggregation] : aggregations)
+            {
+                auto it = std::find(data->column_names.begin(), data->column_names.end(), name);
+                if (it == data->column_names.end())
+                {
+                    throw std::invalid_argument("Column name '" + name + "' was not found.");
+                }
+                size_t y = it - data->column_names.begin();
+                auto position = std::find(value_columns.begin(), value_columns.end(), y);
+                aggregation_values.push_back(position - value_columns.begin());
+                if (position == value_columns.end()) { value_columns.push_back(y); }
+                needs_variance = needs_variance || aggregation == Aggregation::Var;
+            }
+
+            Groups groups = needs_variance ? group<true>(value_columns, n_threads) : group<false>(value_columns, n_threads);
+
+            std::vector<std::string> names;
+            for (auto const& [name, aggregation] : aggregations)
+            {
+                names.push_back(name + "_" + aggregation_name(aggregation));
+            }
+            DataSet<double> result = key_table(groups, names, aggregations.size());
+
+            size_t n_keys = key_columns.size(), n_values = value_columns.size();
+            for (size_t g = 0; g < groups.hashes.size(); ++g)
+            {
+                for (size_t a = 0; a < aggregations.size(); ++a)
+                {
+                    Accumulator const& accumulator = groups.accumulators[g * n_values + aggregation_values[a]];
+                    size_t y = n_keys + a;
+                    switch (aggregations[a].second)
+                    {
+                        case Aggregation::Count: result.set(g, y, (double)accumulator.count); break;
+                        case Aggregation::Sum: result.set(g, y, accumulator.sum); break;
+                        case Aggregation::Mean:
+                            if (accumulator.count == 0) { result.set_null(g, y); }
+                            else { result.set(g, y, accumulator.sum / accumulator.count); }
+                            break;
+                        case Aggregation::Min:
+                            if (accumulator.count == 0) { result.set_null(g, y); }
+                            else { result.set(g, y, accumulator.min); }
+                            break;
+                        case Aggregation::Max:
+                            if (accumulator.count == 0) { result.set_null(g, y); }
+                            else { result.set(g, y, accumulator.max); }
+                            break;
+                        case Aggregation::Var:
+                            // sample variance, like Stats::stdev()
+                            if (accumulator.count < 2) { result.set_null(g, y); }
+                            else { result.set(g, y, accumulator.m2 / (accumulator.count - 1)); }
+                            break;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        // the key columns and the number of rows of every group (in a column named "count")
+        DataSet<double> count(size_t n_threads = 0) const
+        {
+            Groups groups = group<false>({}, n_threads, true);
+            DataSet<double> result = key_table(groups, {"count"}, 1);
+            for (size_t g = 0; g < groups.sizes.size(); ++g)
+            {
+                result.set(g, key_columns.size(), (double)groups.sizes[g]);
+            }
+
+            return result;
+        }
+};
+
+#endif
@@ -0,0 +1,394 @@
+#ifndef GZIPFILE_HPP
+#define GZIPFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+// gzip support needs zlib: define CPPEZML_USE_ZLIB and link with -lz (e.g, g++ -DCPPEZML_USE_ZLIB ... -lz).
+// Without it, gzip files are still recognized but reading or writing them throws.
+#ifdef CPPEZML_USE_ZLIB
+#include <zlib.h>
+#endif
+
+// Decompresses a gzip file on a background thread into chunks of chunk_size bytes,
+// up to read_ahead chunks ahead of the parser.
+//
+//     GzipReader reader("data.csv.gz");
+//     reader.for_each_line([](std::string_view line) { ... });
+class GzipReader
+{
+    private:
+        size_t chunk_size;
+        size_t read_ahead;
+        size_t size_hint = 0;
+
+        // decompressed chunks waiting to be parsed, and buffers handed back for reuse
+        std::deque<std::string> ready_chunks;
+        std::deque<std::string> spare_chunks;
+        std::mutex chunks_mutex;
+        std::condition_variable chunks_changed;
+        bool finished = false;
+        bool stop_requested = false;
+        std::exception_ptr reader_error;
+
+        std::thread worker;
+
+#ifdef CPPEZML_USE_ZLIB
+        gzFile gz_file = nullptr;
+
+        // background thread: decompress until the file ends or the reader is destroyed
+        void decompress_chunks(std::string filepath)
+        {
+            try
+            {
+                while (true)
+                {
+                    std::string chunk;
+                    {
+                        std::lock_guard<std::mutex> lock(chunks_mutex);
+                        if (!spare_chunks.empty())
+                        {
+                            chunk.swap(spare_chunks.front());
+                            spare_chunks.pop_front();
+                        }
+                    }
+
+                    chunk.resize(chunk_size);
+                    int bytes_read = gzread(gz_file, &chunk[0], (unsigned int)chunk_size);
+
+                    int error_code = Z_OK;
+                    const char *error_message = gzerror(gz_file, &error_code);
+                    if (bytes_read < 0 || (error_code != Z_OK && error_code != Z_STREAM_END))
+                    {
+                        throw std::runtime_error("Could not decompress '" + filepath + "': " + error_message);
+                    }
+                    if (bytes_read == 0) { break; }
+
+                    chunk.resize((size_t)bytes_read);
+
+                    std::unique_lock<std::mutex> lock(chunks_mutex);
+                    chunks_changed.wait(lock, [this]() { return ready_chunks.size() < read_ahead || stop_requested; });
+                    if (stop_requested) { return; }
+
+                    ready_chunks.push_back(std::move(chunk));
+                    chunks_changed.notify_all();
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(chunks_mutex);
+                reader_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            finished = true;
+            chunks_changed.notify_all();
+        }
+#endif
+
+    public:
+        explicit GzipReader(std::string const& filepath, size_t chunk_size = 1 << 20, size_t read_ahead = 4)
+            : chunk_size{chunk_size}, read_ahead{read_ahead}
+        {
+            if (chunk_size < 1) { throw std::invalid_argument("chunk_size must be at least one."); }
+            if (read_ahead < 1) { throw std::invalid_argument("read_ahead must be at least one."); }
+
+            std::ifstream datafile(filepath, std::ios::in | std::ios::binary);
+
+            // check if file exists
+            if (datafile.fail())
+            {
+                throw std::runtime_error("There was a problem loading your data!\nCheck your directory/filename.");
+            }
+
+            // the last 4 bytes of a gzip file hold the uncompressed size (modulo 2^32, little endian)
+            datafile.seekg(0, std::ios::end);
+            std::streamoff file_size = datafile.tellg();
+            if (file_size >= 4)
+            {
+                unsigned char trailer[4];
+                datafile.seekg(file_size - 4, std::ios::beg);
+                datafile.read(reinterpret_cast<char *>(trailer), 4);
+                size_hint = (size_t)trailer[0] | ((size_t)trailer[1] << 8) | ((size_t)trailer[2] << 16) | ((size_t)trailer[3] << 24);
+            }
+            size_hint = std::max(size_hint, (size_t)file_size);
+            datafile.close();
+
+#ifdef CPPEZML_USE_ZLIB
+            gz_file = gzopen(filepath.c_str(), "rb");
+            if (gz_file == nullptr)
+            {
+                throw std::runtime_error("There was a problem loading your data!\nCheck your directory/filename.");
+            }
+            // a larger input buffer means fewer reads from the file
+            gzbuffer(gz_file, 1 << 18);
+
+            worker = std::thread(&GzipReader::decompress_chunks, this, filepath);
+#else
+            throw std::runtime_error("'" + filepath + "' is gzip compressed, compile with -DCPPEZML_USE_ZLIB and link with -lz to read it.");
+#endif
+        }
+
+        // the reader owns a thread and an open file
+        GzipReader(GzipReader const&) = delete;
+        GzipReader &operator=(GzipReader const&) = delete;
+
+        ~GzipReader()
+        {
+            {
+                std::lock_guard<std::mutex> lock(chunks_mutex);
+                stop_requested = true;
+            }
+            chunks_changed.notify_all();
+
+            if (worker.joinable()) { worker.join(); }
+
+#ifdef CPPEZML_USE_ZLIB
+            if (gz_file != nullptr) { gzclose(gz_file); }
+#endif
+        }
+
+        // check the gzip magic bytes at the start of a file
+        static bool is_gzip(std::string_view file_start)
+        {
+            return file_start.size() >= 2
+                && (unsigned char)file_start[0] == 0x1f
+                && (unsigned char)file_start[1] == 0x8b;
+        }
+
+        static bool is_gzip_file(std::string const& filepath)
+        {
+            std::ifstream datafile(filepath, std::ios::in | std::ios::binary);
+            char file_start[2] = {0, 0};
+            datafile.read(file_start, 2);
+
+            return datafile.gcount() == 2 && is_gzip(std::string_view(file_start, 2));
+        }
+
+        // estimated size of the decompressed data, to reserve memory up front
+        size_t uncompressed_size_hint() const
+        {
+            return size_hint;
+        }
+
+        // swap the next decompressed chunk into chunk (its old buffer is reused for later chunks).
+        // Returns false at the end of the file, decompression errors are rethrown here.
+        bool next_chunk(std::string &chunk)
+        {
+            std::unique_lock<std::mutex> lock(chunks_mutex);
+            chunks_changed.wait(lock, [this]() { return !ready_chunks.empty() || finished; });
+
+            if (!ready_chunks.empty())
+            {
+                chunk.swap(ready_chunks.front());
+                spare_chunks.push_back(std::move(ready_chunks.front()));
+                ready_chunks.pop_front();
+                chunks_changed.notify_all();
+                return true;
+            }
+
+            if (reader_error) { std::rethrow_exception(reader_error); }
+
+            return false;
+        }
+
+        // call on_line(line) for every line of the file, with the same line semantics as getline():
+        // the newline is removed and a trailing newline does not start another line.
+        // Lines are views into the chunk buffers and only valid during the call
+        template <typename Callback>
+        void for_each_line(Callback &&on_line)
+        {
+            std::string chunk;
+            // start of a line that continues in the next chunk
+            std::string carry;
+
+            while (next_chunk(chunk))
+            {
+                const char *current = chunk.data();
+                const char *chunk_end = chunk.data() + chunk.size();
+
+                while (current < chunk_end)
+                {
+                    const char *line_end = static_cast<const char *>(std::memchr(current, '\n', chunk_end - current));
+                    if (line_end == nullptr)
+                    {
+                        carry.append(current, chunk_end - current);
+                        break;
+                    }
+
+                    if (carry.empty())
+                    {
+                        on_line(std::string_view(current, line_end - current));
+                    }
+                    else
+                    {
+                        carry.append(current, line_end - current);
+                        on_line(std::string_view(carry));
+                        carry.clear();
+                    }
+                    current = line_end + 1;
+                }
+            }
+
+            // the last line doesn't need a trailing newline
+            if (!carry.empty())
+            {
+                on_line(std::string_view(carry));
+            }
+        }
+};
+
+// Compresses data into a gzip file on a background thread, so formatting the next
+// buffer overlaps with compressing the previous one.
+//
+//     GzipWriter writer("data.csv.gz");
+//     writer.write(buffer);
+//     writer.close();
+class GzipWriter
+{
+    private:
+        std::string filepath;
+        size_t write_ahead;
+
+        // buffers waiting to be compressed, and buffers handed back for reuse
+        std::deque<std::string> pending_buffers;
+        std::deque<std::string> spare_buffers;
+        std::mutex buffers_mutex;
+        std::condition_variable buffers_changed;
+        bool closing = false;
+        std::exception_ptr writer_error;
+
+        std::thread worker;
+
+#ifdef CPPEZML_USE_ZLIB
+        gzFile gz_file = nullptr;
+
+        // background thread: compress buffers in the order they were written
+        void compress_buffers()
+        {
+            std::unique_lock<std::mutex> lock(buffers_mutex);
+            while (true)
+            {
+                buffers_changed.wait(lock, [this]() { return !pending_buffers.empty() || closing; });
+                if (pending_buffers.empty()) { break; }
+
+                std::string buffer = std::move(pending_buffers.front());
+                pending_buffers.pop_front();
+                buffers_changed.notify_all();
+
+                if (writer_error == nullptr && !buffer.empty())
+                {
+                    lock.unlock();
+                    int bytes_written = gzwrite(gz_file, buffer.data(), (unsigned int)buffer.size());
+                    lock.lock();
+
+                    if (bytes_written <= 0)
+                    {
+                        int error_code = Z_OK;
+                        writer_error = std::make_exception_ptr(std::runtime_error(
+                            "Could not compress '" + filepath + "': " + gzerror(gz_file, &error_code)));
+                    }
+                }
+
+                buffer.clear();
+                spare_buffers.push_back(std::move(buffer));
+            }
+        }
+#endif
+
+    public:
+        // level goes from 1 (fastest) to 9 (smallest file)
+        explicit GzipWriter(std::string const& filepath, int level = 6, size_t write_ahead = 4)
+            : filepath{filepath}, write_ahead{write_ahead}
+        {
+            if (level < 1 || level > 9) { throw std::invalid_argument("level must be in interval [1, 9]."); }
+            if (write_ahead < 1) { throw std::invalid_argument("write_ahead must be at least one."); }
+
+#ifdef CPPEZML_USE_ZLIB
+            std::string mode = "wb" + std::to_string(level);
+            gz_file = gzopen(filepath.c_str(), mode.c_str());
+            if (gz_file == nullptr)
+            {
+                throw std::runtime_error("Could not open '" + filepath + "' for writing.");
+            }
+            gzbuffer(gz_file, 1 << 18);
+
+            worker = std::thread(&GzipWriter::compress_buffers, this);
+#else
+            throw std::runtime_error("Writing '" + filepath + "' needs gzip, compile with -DCPPEZML_USE_ZLIB and link with -lz.");
+#endif
+        }
+
+        // the writer owns a thread and an open file
+        GzipWriter(GzipWriter const&) = delete;
+        GzipWriter &operator=(GzipWriter const&) = delete;
+
+        ~GzipWriter()
+        {
+            try { close(); }
+            catch (...) {}
+        }
+
+        // hand buffer to the compression thread. buffer is swapped with an empty buffer
+        // (keeping the capacity of an earlier one when possible), so it can be refilled right away
+        void write(std::string &buffer)
+        {
+            std::unique_lock<std::mutex> lock(buffers_mutex);
+            buffers_changed.wait(lock, [this]() { return pending_buffers.size() < write_ahead; });
+
+            if (writer_error) { std::rethrow_exception(writer_error); }
+
+            pending_buffers.push_back(std::move(buffer));
+            buffer.clear();
+            if (!spare_buffers.empty())
+            {
+                buffer.swap(spare_buffers.front());
+                spare_buffers.pop_front();
+            }
+            buffers_changed.notify_all();
+        }
+
+        // compress everything that was written and finish the file.
+        // Errors from the compression thread are rethrown here
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(buffers_mutex);
+                closing = true;
+            }
+            buffers_changed.notify_all();
+
+            if (worker.joinable()) { worker.join(); }
+
+#ifdef CPPEZML_USE_ZLIB
+            if (gz_file != nullptr)
+            {
+                int close_result = gzclose(gz_file);
+                gz_file = nullptr;
+                if (close_result != Z_OK && writer_error == nullptr)
+                {
+                    writer_error = std::make_exception_ptr(std::runtime_error("Could not write to '" + filepath + "'."));
+                }
+            }
+#endif
+
+            if (writer_error)
+            {
+                std::exception_ptr error = writer_error;
+                writer_error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,431 @@
+#ifndef JOIN_HPP
+#define JOIN_HPP
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DataSet.hpp"
+#include "KeyHash.hpp"
+
+// Joins two data sets on one or more key columns. The result has the columns of the left data set,
+// then the columns of the right data set without its keys (named like append(..., 'c') names them,
+// so the names have to be unique between both data sets).
+// Both methods give the same rows: one per matching pair, in the order of the left rows, and the matches
+// of a left row in the order of the right rows. Rows with a null (or NaN) key never match.
+//
+// The hash join builds a hash table of the right rows and probes it with the left rows. It is
+// radix-partitioned: the rows of both sides are first split by the high bits of their key hash, so every
+// partition's hash table stays small enough to be probed from the cache. The sort-merge join only checks
+// data sets that are already sorted by their keys (others are sorted first), then merges them.
+//
+//     DataSet<double> labelled = features.join(labels, {"id"}, JoinType::Left);
+template <class T>
+class Join
+{
+    public:
+        // right rows per partition of the hash join (about 128 KB of hash table)
+        static constexpr size_t PARTITION_ROWS = 1 << 12;
+
+    private:
+        static constexpr size_t NO_ROW = std::numeric_limits<size_t>::max();
+
+        DataSet<T> const *left, *right;
+        std::vector<size_t> left_keys, right_keys;
+
+        // the right rows matching left row r are right_rows[first[r]] to right_rows[first[r] + count[r] - 1]
+        struct Matches
+        {
+            std::vector<size_t> first, count, right_rows;
+        };
+
+        // the rows of one side with a key, their key hashes and where every partition starts in both
+        struct Partitions
+        {
+            std::vector<size_t> rows, offsets;
+            std::vector<uint64_t> hashes;
+        };
+
+        static T const& cell(DataSet<T> const& data, size_t row, size_t column)
+        {
+            return data.data[data.cell_index(row, column)];
+        }
+
+        static bool key_is_null(DataSet<T> const& data, std::vector<size_t> const& keys, size_t row)
+        {
+            for (size_t column : keys)
+            {
+                T const& value = cell(data, row, column);
+                if constexpr (is_text_type_v<T>)
+                {
+                    if (value.empty()) { return true; }
+                }
+                else
+                {
+                    if (!data.cell_is_valid(row, column)) { return true; }
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        if (value != value) { return true; }
+                    }
+                }
+            }
+            return false;
+        }
+
+        static uint64_t hash_keys(DataSet<T> const& data, std::vector<size_t> const& keys, size_t row)
+        {
+            uint64_t h = 0;
+            for (size_t column : keys)
+            {
+                T value = cell(data, row, column);
+                if constexpr (std::is_arithmetic_v<T>)
+                {
+                    h = KeyHash::mix(h ^ KeyHash::key_bits(value));
+                }
+                else
+                {
+                    h = KeyHash::mix(h ^ std::hash<T>{}(value));
+                }
+            }
+            return h;
+        }
+
+        // -1, 0 or 1 as the keys of row a (of data set a) sort before, with or after the keys of row b
+        static int compare_keys(DataSet<T> const& a, std::vector<size_t> const& a_keys, size_t a_row,
+                                DataSet<T> const& b, std::vector<size_t> const& b_keys, size_t b_row)
+        {
+            for (size_t k = 0; k < a_keys.size(); ++k)
+            {
+                T const& a_value = cell(a, a_row, a_keys[k]);
+                T const& b_value = cell(b, b_row, b_keys[k]);
+                if (a_value < b_value) { return -1; }
+                if (b_value < a_value) { return 1; }
+            }
+            return 0;
+        }
+
+        // split the rows of data with a key into n_partitions partitions (a power of two) by the high bits
+        // of their hash, keeping the rows of every partition in order
+        static Partitions partition(DataSet<T> const& data, std::vector<size_t> const& keys, size_t n_partitions)
+        {
+            size_t shift = 64;
+            while (((size_t)1 << (64 - shift)) < n_partitions) { --shift; }
+            auto partition_of = [shift](uint64_t h) { return shift == 64 ? 0 : (size_t)(h >> shift); };
+
+            std::vector<size_t> rows;
+            std::vector<uint64_t> hashes;
+            rows.reserve(data.rows);
+            hashes.reserve(data.rows);
+            for (size_t row = 0; row < data.rows; ++row)
+            {
+                if (key_is_null(data, keys, row)) { continue; }
+                rows.push_back(row);
+                hashes.push_back(hash_keys(data, keys, row));
+            }
+
+            Partitions partitions;
+            partitions.offsets.assign(n_partitions + 1, 0);
+            if (n_partitions == 1)
+            {
+                partitions.offsets[1] = rows.size();
+                partitions.rows = std::move(rows);
+                partitions.hashes = std::move(hashes);
+                return partitions;
+            }
+
+            for (uint64_t h : hashes) { partitions.offsets[partition_of(h) + 1] += 1; }
+            for (size_t p = 0; p < n_partitions; ++p) { partitions.offsets[p + 1] += partitions.offsets[p]; }
+
+            std::vector<size_t> next(partitions.offsets.begin(), partitions.offsets.end() - 1);
+            partitions.rows.resize(rows.size());
+            partitions.hashes.resize(rows.size());
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                size_t target = next[partition_of(hashes[i])]++;
+                partitions.rows[target] = rows[i];
+                partitions.hashes[target] = hashes[i];
+            }
+
+            return partitions;
+        }
+
+        // match the left rows against a hash table of the right rows, partition by partition.
+        // Every distinct key of a partition has one slot, its rows are chained in order
+        Matches hash_matches() const
+        {
+            size_t n_partitions = 1;
+            while (n_partitions * PARTITION_ROWS < right->rows) { n_partitions *= 2; }
+
+            Partitions built = partition(*right, right_keys, n_partitions);
+            Partitions probed = partition(*left, left_keys, n_partitions);
+
+            Matches matches;
+            matches.first.resize(left->rows);
+            matches.count.assign(left->rows, 0);
+            matches.right_rows.reserve(probed.rows.size());
+            // slot s holds the first row of its key + 1 (0 = empty slot)
+            std::vector<size_t> slots, next;
+            std::vector<uint64_t> slot_hashes;
+            for (size_t p = 0; p < n_partitions; ++p)
+            {
+                size_t build_first = built.offsets[p], build_count = built.offsets[p + 1] - build_first;
+                if (build_count == 0) { continue; }
+
+                // at most half full
+                size_t n_slots = 16;
+                while (n_slots < 2 * build_count) { n_slots *= 2; }
+                size_t mask = n_slots - 1;
+                slots.assign(n_slots, 0);
+                slot_hashes.resize(n_slots);
+                next.assign(build_count, NO_ROW);
+
+                // find the slot of the key of a row of data (or the empty slot it would go in)
+                auto find_slot = [&](uint64_t h, DataSet<T> const& data, std::vector<size_t> const& keys, size_t row)
+                {
+                    size_t s = h & mask;
+                    while (slots[s] != 0
+                           && (slot_hashes[s] != h
+                               || compare_keys(*right, right_keys, built.rows[build_first + slots[s] - 1], data, keys, row) != 0))
+                    {
+                        s = (s + 1) & mask;
+                    }
+                    return s;
+                };
+
+                // rows are added from the last one, so every chain lists its rows in order
+                for (size_t i = build_count; i-- > 0;)
+                {
+                    uint64_t h = built.hashes[build_first + i];
+                    size_t s = find_slot(h, *right, right_keys, built.rows[build_first + i]);
+                    if (slots[s] != 0) { next[i] = slots[s] - 1; }
+                    slots[s] = i + 1;
+                    slot_hashes[s] = h;
+                }
+
+                for (size_t i = probed.offsets[p]; i < probed.offsets[p + 1]; ++i)
+                {
+                    size_t row = probed.rows[i];
+                    size_t s = find_slot(probed.hashes[i], *left, left_keys, row);
+                    if (slots[s] == 0) { continue; }
+
+                    matches.first[row] = matches.right_rows.size();
+                    for (size_t b = slots[s] - 1; b != NO_ROW; b = next[b])
+                    {
+                        matches.right_rows.push_back(built.rows[build_first + b]);
+                    }
+                    matches.count[row] = matches.right_rows.size() - matches.first[row];
+                }
+            }
+
+            return matches;
+        }
+
+        // the rows of data with a key, in key order (rows with the same key stay in order).
+        // Data sets that are already sorted by their keys are only checked
+        static std::vector<size_t> sorted_rows(DataSet<T> const& data, std::vector<size_t> const& keys)
+        {
+            std::vector<size_t> rows;
+            rows.reserve(data.rows);
+            for (size_t row = 0; row < data.rows; ++row)
+            {
+                if (!key_is_null(data, keys, row)) { rows.push_back(row); }
+            }
+
+            auto less = [&](size_t a, size_t b) { return compare_keys(data, keys, a, data, keys, b) < 0; };
+            if (!std::is_sorted(rows.begin(), rows.end(), less))
+            {
+                std::stable_sort(rows.begin(), rows.end(), less);
+            }
+
+            return rows;
+        }
+
+        // walk both sides in key order, matching every run of equal left keys with the run of the right
+        Matches sort_merge_matches() const
+        {
+            std::vector<size_t> left_rows = sorted_rows(*left, left_keys);
+            std::vector<size_t> right_rows = sorted_rows(*right, right_keys);
+
+            Matches matches;
+            matches.first.resize(left->rows);
+            matches.count.assign(left->rows, 0);
+            size_t i = 0, j = 0;
+            while (i < left_rows.size() && j < right_rows.size())
+            {
+                int order = compare_keys(*left, left_keys, left_rows[i], *right, right_keys, right_rows[j]);
+                if (order < 0) { ++i; continue; }
+                if (order > 0) { ++j; continue; }
+
+                size_t run_end = j + 1;
+                while (run_end < right_rows.size()
+                       && compare_keys(*right, right_keys, right_rows[run_end], *right, right_keys, right_rows[j]) == 0)
+                {
+                    ++run_end;
+                }
+
+                // the left rows of the run share its matches
+                size_t first = matches.right_rows.size(), first_left = left_rows[i];
+                matches.right_rows.insert(matches.right_rows.end(), right_rows.begin() + j, right_rows.begin() + run_end);
+                do
+                {
+                    matches.first[left_rows[i]] = first;
+                    matches.count[left_rows[i]] = run_end - j;
+                    ++i;
+                }
+                while (i < left_rows.size() && compare_keys(*left, left_keys, left_rows[i], *left, left_keys, first_left) == 0);
+
+                j = run_end;
+            }
+
+            return matches;
+        }
+
+        // the joined data set: the matches of every left row in order (and for a left join the unmatched
+        // left rows once), gathered row by row (or column by column into column-major data sets),
+        // then the null cells are marked for the columns that have any
+        DataSet<T> gather(Matches const& matches, JoinType how) const
+        {
+            size_t n_rows = 0;
+            bool has_unmatched = false;
+            for (size_t row = 0; row < left->rows; ++row)
+            {
+                n_rows += how == JoinType::Left ? std::max<size_t>(matches.count[row], 1) : matches.count[row];
+                has_unmatched = has_unmatched || (how == JoinType::Left && matches.count[row] == 0);
+            }
+
+            // visit(i, left_row, right_row) for every row i of the joined data set (right_row is NO_ROW if unmatched)
+            auto for_each_row = [&](auto &&visit)
+            {
+                size_t i = 0;
+                for (size_t row = 0; row < left->rows; ++row)
+                {
+                    if (matches.count[row] == 0 && how == JoinType::Left) { visit(i++, row, NO_ROW); }
+                    for (size_t m = 0; m < matches.count[row]; ++m) { visit(i++, row, matches.right_rows[matches.first[row] + m]); }
+                }
+            };
+
+            std::vector<size_t> right_columns;
+            for (size_t y = 0; y < right->columns; ++y)
+            {
+                if (std::find(right_keys.begin(), right_keys.end(), y) == right_keys.end()) { right_columns.push_back(y); }
+            }
+
+            DataSet<T> joined(n_rows, left->columns + right_columns.size(), left->layout);
+            joined.column_names = column_names(right_columns);
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                // left cells keep pointing into the text of the left data set, right cells are copied
+                joined.mapped_file = left->mapped_file;
+                joined.owned_strings = left->owned_strings;
+            }
+
+            auto copy_cell = [&](size_t i, size_t left_row, size_t right_row, size_t y)
+            {
+                if (y < left->columns)
+                {
+                    joined.data[joined.cell_index(i, y)] = cell(*left, left_row, y);
+                }
+                else if (right_row != NO_ROW)
+                {
+                    joined.template store_cell<false>(joined.cell_index(i, y), cell(*right, right_row, right_columns[y - left->columns]));
+                }
+            };
+            if (joined.layout == Layout::RowMajor)
+            {
+                for_each_row([&](size_t i, size_t left_row, size_t right_row)
+                {
+                    for (size_t y = 0; y < joined.columns; ++y) { copy_cell(i, left_row, right_row, y); }
+                });
+            }
+            else
+            {
+                for (size_t y = 0; y < joined.columns; ++y)
+                {
+                    for_each_row([&](size_t i, size_t left_row, size_t right_row) { copy_cell(i, left_row, right_row, y); });
+                }
+            }
+
+            if constexpr (!is_text_type_v<T>)
+            {
+                for (size_t y = 0; y < left->validity.size(); ++y)
+                {
+                    if (left->validity[y].empty()) { continue; }
+                    for_each_row([&](size_t i, size_t left_row, size_t)
+                    {
+                        if (!left->cell_is_valid(left_row, y)) { joined.set_null(i, y); }
+                    });
+                }
+
+                for (size_t j = 0; j < right_columns.size(); ++j)
+                {
+                    size_t y = right_columns[j];
+                    if (!has_unmatched && (y >= right->validity.size() || right->validity[y].empty())) { continue; }
+                    for_each_row([&](size_t i, size_t, size_t right_row)
+                    {
+                        if (right_row == NO_ROW || !right->cell_is_valid(right_row, y)) { joined.set_null(i, left->columns + j); }
+                    });
+                }
+            }
+
+            return joined;
+        }
+
+        // the column names of the joined data set, unique between both data sets like when appending columns.
+        // Unnamed left data sets give an unnamed result, unnamed right columns are named "col<index>"
+        std::vector<std::string> column_names(std::vector<size_t> const& right_columns) const
+        {
+            if (left->column_names.empty() && left->columns > 0) { return {}; }
+
+            std::vector<std::string> names = left->column_names;
+            for (size_t j = 0; j < right_columns.size(); ++j)
+            {
+                size_t y = right_columns[j];
+                names.push_back(y < right->column_names.size() ? right->column_names[y] : "col" + std::to_string(left->columns + j));
+            }
+
+            std::vector<std::string> sorted_names = names;
+            std::sort(sorted_names.begin(), sorted_names.end());
+            if (std::adjacent_find(sorted_names.begin(), sorted_names.end()) != sorted_names.end())
+            {
+                throw std::runtime_error("Columns must be uniquely named between both data sets when joining.");
+            }
+
+            return names;
+        }
+
+    public:
+        Join(DataSet<T> const& left, DataSet<T> const& right, std::vector<size_t> left_keys, std::vector<size_t> right_keys)
+            : left{&left}, right{&right}, left_keys{std::move(left_keys)}, right_keys{std::move(right_keys)}
+        {
+            if (this->left_keys.empty() || this->left_keys.size() != this->right_keys.size())
+            {
+                throw std::invalid_argument("join() needs the same number of key columns (at least one) on both sides.");
+            }
+            for (size_t k = 0; k < this->left_keys.size(); ++k)
+            {
+                if (this->left_keys[k] >= left.columns || this->right_keys[k] >= right.columns)
+                {
+                    throw std::out_of_range("Key column " + std::to_string(std::max(this->left_keys[k], this->right_keys[k]))
+                        + " is out of range for the data sets joined.");
+                }
+            }
+        }
+
+        // the hash table is built from the right data set (the smaller one, for the best speed)
+        DataSet<T> hash_join(JoinType how = JoinType::Inner) const
+        {
+            return gather(hash_matches(), how);
+        }
+
+        DataSet<T> sort_merge_join(JoinType how = JoinType::Inner) const
+        {
+            return gather(sort_merge_matches(), how);
+        }
+};
+
+#endif
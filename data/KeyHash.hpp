@@ -0,0 +1,49 @@
+#ifndef KEYHASH_HPP
+#define KEYHASH_HPP
+
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+// Hashing of numeric key values for hash tables over the rows of a data set (e.g, the groups of group_by()).
+// A row hash is built by mixing in the bits of one key at a time: h = KeyHash::mix(h ^ KeyHash::key_bits(value))
+struct KeyHash
+{
+    // finalizer of MurmurHash3, spreads every input bit over the whole hash
+    static uint64_t mix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // bits of a key value, with 0.0 and -0.0 (and every NaN) hashed the same since they compare the same.
+    // A long double can have more than 8 significant bytes (10 for x87, whose last 2 hold the sign and
+    // exponent, followed by padding that is never read), both 8 byte halves are mixed into the bits
+    template <class T>
+    static uint64_t key_bits(T value)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only numeric keys are hashed by their bits.");
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            constexpr size_t VALUE_BYTES = std::numeric_limits<T>::digits == 64 ? 10 : sizeof(T);
+            if (value == 0) { value = 0; }
+            if (value != value) { value = std::numeric_limits<T>::quiet_NaN(); }
+            uint64_t bits[2] = {0, 0};
+            std::memcpy(bits, &value, std::min(VALUE_BYTES, sizeof(bits)));
+            return VALUE_BYTES > sizeof(uint64_t) ? bits[0] ^ mix(bits[1]) : bits[0];
+        }
+        else
+        {
+            return (uint64_t)value;
+        }
+    }
+};
+
+#endif
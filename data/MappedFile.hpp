@@ -0,0 +1,140 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MAPPEDFILE_USE_MMAP 1
+#endif
+
+// View of a whole file in memory.
+// On POSIX systems the file is memory mapped so nothing is copied until the pages are touched,
+// everywhere else the file is read into a heap buffer once.
+// With copy_on_write the memory is writable, but changes stay private to the process and never
+// reach the file (pages are copied by the OS when they are first written).
+// DataSets that hold views into the file keep it alive through a std::shared_ptr<MappedFile>.
+class MappedFile
+{
+    private:
+        char *file_data = nullptr;
+        size_t file_size = 0;
+
+#ifdef MAPPEDFILE_USE_MMAP
+        void *mapping = nullptr;
+#else
+        std::string buffer;
+#endif
+
+    public:
+        explicit MappedFile(std::string const& filepath, bool copy_on_write = false)
+        {
+#ifdef MAPPEDFILE_USE_MMAP
+            int fd = ::open(filepath.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("There was a problem loading your data!\nCheck your directory/filename.");
+            }
+
+            struct stat file_stats;
+            if (::fstat(fd, &file_stats) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("Could not read the size of '" + filepath + "'.");
+            }
+
+            this->file_size = (size_t)file_stats.st_size;
+
+            // mmap() refuses zero-length mappings, an empty file simply has no data
+            if (this->file_size > 0)
+            {
+                int protection = copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+                this->mapping = ::mmap(nullptr, this->file_size, protection, MAP_PRIVATE, fd, 0);
+                if (this->mapping == MAP_FAILED)
+                {
+                    this->mapping = nullptr;
+                    ::close(fd);
+                    throw std::runtime_error("Could not memory map '" + filepath + "'.");
+                }
+
+                // read-only mappings are text files that get parsed front to back
+                if (!copy_on_write)
+                {
+                    ::madvise(this->mapping, this->file_size, MADV_SEQUENTIAL);
+                }
+                this->file_data = static_cast<char *>(this->mapping);
+            }
+
+            // the mapping stays valid after the descriptor is closed
+            ::close(fd);
+#else
+            // a heap buffer is always private and writable
+            (void)copy_on_write;
+
+            std::ifstream datafile(filepath, std::ios::in | std::ios::binary);
+            if (datafile.fail())
+            {
+                throw std::runtime_error("There was a problem loading your data!\nCheck your directory/filename.");
+            }
+
+            datafile.seekg(0, std::ios::end);
+            this->buffer.resize((size_t)datafile.tellg());
+            datafile.seekg(0, std::ios::beg);
+            datafile.read(&this->buffer[0], this->buffer.size());
+
+            this->file_data = &this->buffer[0];
+            this->file_size = this->buffer.size();
+#endif
+        }
+
+        // the mapping is owned, copies would unmap it twice
+        MappedFile(MappedFile const&) = delete;
+        MappedFile &operator=(MappedFile const&) = delete;
+
+        ~MappedFile()
+        {
+#ifdef MAPPEDFILE_USE_MMAP
+            if (this->mapping != nullptr)
+            {
+                ::munmap(this->mapping, this->file_size);
+            }
+#endif
+        }
+
+        const char *data() const
+        {
+            return file_data;
+        }
+
+        // only write through this pointer if the file was opened with copy_on_write
+        char *writable_data()
+        {
+            return file_data;
+        }
+
+        size_t size() const
+        {
+            return file_size;
+        }
+
+        std::string_view view() const
+        {
+            return std::string_view(file_data, file_size);
+        }
+
+        // check if a string_view points somewhere inside of the file
+        bool contains(std::string_view text) const
+        {
+            return file_data != nullptr
+                && text.data() >= file_data
+                && text.data() + text.size() <= file_data + file_size;
+        }
+};
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef MIXEDDATASET_HPP
+#define MIXEDDATASET_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DataSet.hpp"
+
+enum class ColumnType { Numeric, Text };
+
+// Loads a CSV file with both numeric and text columns in one pass. Every column is parsed straight
+// into its final type following a schema (one ColumnType per file column), so numbers never go
+// through a DataSet<std::string> first. Numeric columns end up in numeric, text columns in text,
+// both keep the order and names the columns have in the file.
+// Without a schema, it's inferred from the first sample_rows rows: a column is numeric if every
+// sampled value is a complete number or empty, anything else makes it text. Empty or missing values
+// in numeric columns are loaded as nulls (see DataSet::is_null()).
+//
+//     MixedDataSet<double> mydata("example_data.csv");
+//     DataSet<double> features = mydata.numeric;
+template <class N = double>
+class MixedDataSet
+{
+    static_assert(std::is_arithmetic_v<N>, "The numeric columns of a MixedDataSet need an arithmetic type.");
+
+    private:
+        // where every file column ended up inside numeric or text
+        std::vector<size_t> column_positions;
+
+        // next line of the file with getline() semantics, moves current past it
+        static std::string_view next_line(const char *&current, const char *file_end)
+        {
+            const char *line_end = static_cast<const char *>(std::memchr(current, '\n', file_end - current));
+            if (line_end == nullptr) { line_end = file_end; }
+
+            std::string_view line(current, line_end - current);
+            current = line_end + 1;
+            return line;
+        }
+
+        // read the column names (or count the columns) from the first line and return where the rows start
+        const char *read_header(MappedFile const& file, std::string const& sep, bool has_headers, size_t &columns)
+        {
+            const char *current = file.data();
+            const char *file_end = file.data() + file.size();
+
+            column_names.clear();
+            if (current == file_end)
+            {
+                columns = 0;
+                return file_end;
+            }
+
+            const char *first_line_start = current;
+            std::string_view first_line = next_line(current, file_end);
+
+            if (has_headers)
+            {
+                CSVTokenizer::for_each_field(first_line, sep, [&](size_t, std::string_view field)
+                {
+                    column_names.push_back(std::string(field));
+                });
+
+                std::vector<std::string> unique_names = column_names;
+                std::sort(unique_names.begin(), unique_names.end());
+                if (std::unique(unique_names.begin(), unique_names.end()) != unique_names.end())
+                {
+                    throw std::runtime_error("Columns must be uniquely named when loading");
+                }
+
+                columns = column_names.size();
+                return std::min(current, file_end);
+            }
+
+            columns = CSVTokenizer::count_fields(first_line, sep);
+            return first_line_start;
+        }
+
+        static std::vector<ColumnType> infer_schema(MappedFile const& file, const char *rows_start, size_t columns,
+                                                    std::string const& sep, size_t sample_rows)
+        {
+            // columns stay numeric until a sampled value says otherwise
+            std::vector<ColumnType> schema(columns, ColumnType::Numeric);
+
+            const char *current = rows_start;
+            const char *file_end = file.data() + file.size();
+            for (size_t row = 0; row < sample_rows && current < file_end; ++row)
+            {
+                std::string_view line = next_line(current, file_end);
+                CSVTokenizer::for_each_field(line, sep, [&](size_t column, std::string_view field)
+                {
+                    // empty values are nulls, they fit either type
+                    if (column < columns && !NumberParser::is_blank(field) && !NumberParser::is_number<N>(field))
+                    {
+                        schema[column] = ColumnType::Text;
+                    }
+                });
+            }
+
+            return schema;
+        }
+
+        void parse_rows(MappedFile const& file, const char *rows_start, std::vector<ColumnType> const& schema, std::string const& sep)
+        {
+            const char *file_end = file.data() + file.size();
+            size_t columns = schema.size();
+
+            // split the columns between the two data sets
+            column_positions.assign(columns, 0);
+            std::vector<std::string> numeric_names, text_names;
+            for (size_t column = 0; column < columns; ++column)
+            {
+                std::vector<std::string> &names = schema[column] == ColumnType::Numeric ? numeric_names : text_names;
+                column_positions[column] = names.size();
+                names.push_back(column < column_names.size() ? column_names[column] : std::string());
+            }
+
+            // rows are counted up front so both data sets are allocated once
+            size_t row_count = 0;
+            if (rows_start < file_end)
+            {
+                row_count = std::count(rows_start, file_end, '\n');
+                if (*(file_end - 1) != '\n') { row_count += 1; }
+            }
+
+            numeric = DataSet<N>(row_count, numeric_names.size());
+            text = DataSet<std::string>(row_count, text_names.size());
+            if (!column_names.empty())
+            {
+                numeric.set_column_names(numeric_names);
+                text.set_column_names(text_names);
+            }
+
+            const char *current = rows_start;
+            for (size_t row = 0; row < row_count; ++row)
+            {
+                std::string_view line = next_line(current, file_end);
+                size_t fields = CSVTokenizer::for_each_field(line, sep, [&](size_t column, std::string_view field)
+                {
+                    // ignore any fields past the expected column count, like DataSet::load()
+                    if (column >= columns) { return; }
+
+                    if (schema[column] == ColumnType::Numeric)
+                    {
+                        if (NumberParser::is_blank(field))
+                        {
+                            numeric.set_null(row, column_positions[column]);
+                        }
+                        else
+                        {
+                            numeric(row, column_positions[column]) = NumberParser::parse_cell<N>(field, row, column);
+                        }
+                    }
+                    else
+                    {
+                        text(row, column_positions[column]) = std::string(field);
+                    }
+                });
+
+                // missing numeric fields are nulls too
+                for (size_t column = fields; column < columns; ++column)
+                {
+                    if (schema[column] == ColumnType::Numeric)
+                    {
+                        numeric.set_null(row, column_positions[column]);
+                    }
+                }
+            }
+        }
+
+    public:
+        std::vector<std::string> column_names;
+        std::vector<ColumnType> column_types;
+
+        DataSet<N> numeric;
+        DataSet<std::string> text;
+
+        MixedDataSet() {}
+
+        // load with a schema inferred from the first sample_rows rows
+        MixedDataSet(std::string filepath, std::string sep = ",", bool has_headers = true, size_t sample_rows = 1000)
+        {
+            this->load(filepath, sep, has_headers, sample_rows);
+        }
+
+        // load with a schema of one ColumnType per file column
+        MixedDataSet(std::string filepath, std::vector<ColumnType> const& schema, std::string sep = ",", bool has_headers = true)
+        {
+            this->load(filepath, schema, sep, has_headers);
+        }
+
+        // guess the type of every column from the first sample_rows rows of a file
+        std::vector<ColumnType> infer_schema(std::string filepath, std::string sep = ",", bool has_headers = true, size_t sample_rows = 1000)
+        {
+            MappedFile file(filepath);
+            size_t columns = 0;
+            const char *rows_start = read_header(file, sep, has_headers, columns);
+
+            return infer_schema(file, rows_start, columns, sep, sample_rows);
+        }
+
+        void load(std::string filepath, std::string sep = ",", bool has_headers = true, size_t sample_rows = 1000)
+        {
+            MappedFile file(filepath);
+            size_t columns = 0;
+            const char *rows_start = read_header(file, sep, has_headers, columns);
+
+            this->column_types = infer_schema(file, rows_start, columns, sep, sample_rows);
+            parse_rows(file, rows_start, this->column_types, sep);
+        }
+
+        void load(std::string filepath, std::vector<ColumnType> const& schema, std::string sep = ",", bool has_headers = true)
+        {
+            MappedFile file(filepath);
+            size_t columns = 0;
+            const char *rows_start = read_header(file, sep, has_headers, columns);
+
+            if (schema.size() != columns)
+            {
+                throw std::invalid_argument("The schema has " + std::to_string(schema.size()) + " columns, but the file has "
+                    + std::to_string(columns) + ".");
+            }
+
+            this->column_types = schema;
+            parse_rows(file, rows_start, this->column_types, sep);
+        }
+
+        size_t count_rows()
+        {
+            return std::max(numeric.count_rows(), text.count_rows());
+        }
+
+        // number of columns in the file (numeric and text together)
+        size_t count_columns()
+        {
+            return column_types.size();
+        }
+
+        ColumnType get_column_type(size_t column)
+        {
+            return column_types.at(column);
+        }
+
+        // position of a file column inside numeric (for numeric columns) or text (for text columns)
+        size_t get_column_position(size_t column)
+        {
+            return column_positions.at(column);
+        }
+};
+
+#endif
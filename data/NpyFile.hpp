@@ -0,0 +1,461 @@
+#ifndef NPYFILE_HPP
+#define NPYFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+// Reads and writes the NumPy formats:
+//   .npy: magic "\x93NUMPY", uint8 major, uint8 minor, uint16 (version 1) or uint32 (version 2/3)
+//         header length, a Python dict literal with 'descr', 'fortran_order' and 'shape' padded
+//         with spaces and a newline, then the raw array in C (row-major) or Fortran (column-major) order.
+//   .npz: a zip archive of .npy files. Only stored (uncompressed) entries can be read, the way
+//         np.savez writes them; np.savez_compressed archives are rejected.
+// All multi-byte zip fields are little endian no matter which machine reads or writes them.
+
+// description of the array in a .npy header
+struct NpyHeader
+{
+    // 'f' floating point, 'i' signed, 'u' unsigned, 'b' bool
+    char kind = 0;
+    size_t item_size = 0;
+    bool swapped_byte_order = false;
+    bool fortran_order = false;
+    std::vector<size_t> shape;
+    // offset of the array data from the start of the .npy bytes
+    size_t data_offset = 0;
+};
+
+class NpyFile
+{
+    private:
+        static constexpr char MAGIC[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+        static bool is_little_endian()
+        {
+            uint16_t probe = 1;
+            unsigned char first_byte;
+            std::memcpy(&first_byte, &probe, 1);
+            return first_byte == 1;
+        }
+
+        static uint64_t read_le(const char *bytes, size_t size)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                value |= (uint64_t)(unsigned char)bytes[i] << (8 * i);
+            }
+            return value;
+        }
+
+        static void write_le(std::string &out, uint64_t value, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                out += (char)((value >> (8 * i)) & 0xFF);
+            }
+        }
+
+        // text of a dict entry, e.g. value_of(header, "descr") on "{'descr': '<f8', ..." is "'<f8', ..."
+        static std::string_view value_of(std::string_view header, std::string_view key, std::string const& file_name)
+        {
+            std::string quoted_key = "'" + std::string(key) + "'";
+            size_t key_position = header.find(quoted_key);
+            if (key_position == std::string_view::npos)
+            {
+                throw std::runtime_error("'" + file_name + "' has no " + std::string(key) + " in its .npy header.");
+            }
+
+            size_t colon = header.find(':', key_position + quoted_key.size());
+            if (colon == std::string_view::npos)
+            {
+                throw std::runtime_error("'" + file_name + "' has a malformed .npy header.");
+            }
+
+            size_t value_start = header.find_first_not_of(' ', colon + 1);
+            return value_start == std::string_view::npos ? std::string_view() : header.substr(value_start);
+        }
+
+        // find an entry of a zip archive through its central directory
+        struct ZipEntry
+        {
+            std::string name;
+            uint16_t method = 0;
+            uint64_t compressed_size = 0;
+            uint64_t uncompressed_size = 0;
+            uint64_t local_header_offset = 0;
+        };
+
+        static std::vector<ZipEntry> read_zip_entries(std::string_view archive, std::string const& file_name)
+        {
+            const char *begin = archive.data();
+            size_t size = archive.size();
+            auto truncated = [&]() { return std::runtime_error("'" + file_name + "' is not a valid .npz archive."); };
+
+            // the end of central directory record sits in the last 64 KiB + 22 bytes (after an optional comment)
+            if (size < 22) { throw truncated(); }
+            size_t eocd = size - 22;
+            size_t search_end = size > 65557 ? size - 65557 : 0;
+            while (read_le(begin + eocd, 4) != 0x06054b50)
+            {
+                if (eocd == search_end) { throw truncated(); }
+                eocd -= 1;
+            }
+
+            uint64_t entry_count = read_le(begin + eocd + 10, 2);
+            uint64_t directory_offset = read_le(begin + eocd + 16, 4);
+
+            // zip64 archives keep the real values in another record just before it
+            if ((entry_count == 0xFFFF || directory_offset == 0xFFFFFFFF) && eocd >= 20
+                && read_le(begin + eocd - 20, 4) == 0x07064b50)
+            {
+                uint64_t zip64_eocd = read_le(begin + eocd - 20 + 8, 8);
+                if (zip64_eocd + 56 > size || read_le(begin + zip64_eocd, 4) != 0x06064b50) { throw truncated(); }
+                entry_count = read_le(begin + zip64_eocd + 32, 8);
+                directory_offset = read_le(begin + zip64_eocd + 48, 8);
+            }
+
+            std::vector<ZipEntry> entries;
+            uint64_t position = directory_offset;
+            for (uint64_t i = 0; i < entry_count; ++i)
+            {
+                if (position + 46 > size || read_le(begin + position, 4) != 0x02014b50) { throw truncated(); }
+
+                ZipEntry entry;
+                entry.method = (uint16_t)read_le(begin + position + 10, 2);
+                entry.compressed_size = read_le(begin + position + 20, 4);
+                entry.uncompressed_size = read_le(begin + position + 24, 4);
+                size_t name_length = read_le(begin + position + 28, 2);
+                size_t extra_length = read_le(begin + position + 30, 2);
+                size_t comment_length = read_le(begin + position + 32, 2);
+                entry.local_header_offset = read_le(begin + position + 42, 4);
+
+                if (position + 46 + name_length + extra_length > size) { throw truncated(); }
+                entry.name.assign(begin + position + 46, name_length);
+
+                // zip64 extra field: 64 bit values for every 32 bit field that is 0xFFFFFFFF, in this order
+                const char *extra = begin + position + 46 + name_length;
+                const char *extra_end = extra + extra_length;
+                while (extra_end - extra >= 4)
+                {
+                    uint64_t field_id = read_le(extra, 2);
+                    uint64_t field_size = read_le(extra + 2, 2);
+                    const char *field = extra + 4;
+                    if ((uint64_t)(extra_end - field) < field_size) { break; }
+
+                    if (field_id == 0x0001)
+                    {
+                        const char *field_end = field + field_size;
+                        for (uint64_t *value : {&entry.uncompressed_size, &entry.compressed_size, &entry.local_header_offset})
+                        {
+                            if (*value == 0xFFFFFFFF && field_end - field >= 8)
+                            {
+                                *value = read_le(field, 8);
+                                field += 8;
+                            }
+                        }
+                    }
+                    extra = extra + 4 + field_size;
+                }
+
+                entries.push_back(entry);
+                position += 46 + name_length + extra_length + comment_length;
+            }
+
+            return entries;
+        }
+
+        // running CRC-32 (the zip polynomial) of size bytes
+        static uint32_t crc32(uint32_t crc, const char *bytes, size_t size)
+        {
+            static const std::vector<uint32_t> table = []()
+            {
+                std::vector<uint32_t> values(256);
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t value = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                    }
+                    values[i] = value;
+                }
+                return values;
+            }();
+
+            crc = ~crc;
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ (unsigned char)bytes[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+    public:
+        // dtype string of T, e.g. "<f8" for double on a little endian machine
+        template <typename T>
+        static std::string descr()
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only numeric types can be stored in .npy files.");
+
+            char kind;
+            if constexpr (std::is_same_v<T, bool>) { kind = 'b'; }
+            else if constexpr (std::is_floating_point_v<T>) { kind = 'f'; }
+            else if constexpr (std::is_signed_v<T>) { kind = 'i'; }
+            else { kind = 'u'; }
+
+            char byte_order = sizeof(T) == 1 ? '|' : (is_little_endian() ? '<' : '>');
+            return std::string(1, byte_order) + kind + std::to_string(sizeof(T));
+        }
+
+        // magic, version and header of a 2D .npy array with elements of type T in C order
+        // (or Fortran order, i.e, column by column)
+        template <typename T>
+        static std::string make_header(size_t rows, size_t columns, bool fortran_order = false)
+        {
+            std::string header = "{'descr': '" + descr<T>() + "', 'fortran_order': " + (fortran_order ? "True" : "False") + ", 'shape': ("
+                + std::to_string(rows) + ", " + std::to_string(columns) + "), }";
+
+            // version 1.0 stores the header length in 16 bits, version 2.0 in 32 bits
+            bool needs_version_2 = header.size() + 1 + 10 > 0xFFFF;
+            size_t preamble_size = needs_version_2 ? 12 : 10;
+
+            // numpy pads the header with spaces so the data starts on a multiple of 64 bytes
+            size_t total_size = (preamble_size + header.size() + 1 + 63) / 64 * 64;
+            header.append(total_size - preamble_size - header.size() - 1, ' ');
+            header += '\n';
+
+            std::string preamble(MAGIC, sizeof(MAGIC));
+            preamble += (char)(needs_version_2 ? 2 : 1);
+            preamble += (char)0;
+            write_le(preamble, header.size(), needs_version_2 ? 4 : 2);
+
+            return preamble + header;
+        }
+
+        // read the header of the .npy bytes in array
+        static NpyHeader parse_header(std::string_view array, std::string const& file_name)
+        {
+            if (array.size() < 10 || std::memcmp(array.data(), MAGIC, sizeof(MAGIC)) != 0)
+            {
+                throw std::runtime_error("'" + file_name + "' is not a .npy file.");
+            }
+
+            unsigned char major_version = (unsigned char)array[6];
+            size_t preamble_size = major_version == 1 ? 10 : 12;
+            if (major_version < 1 || major_version > 3 || array.size() < preamble_size)
+            {
+                throw std::runtime_error("'" + file_name + "' uses an unsupported .npy version.");
+            }
+
+            size_t header_size = read_le(array.data() + 8, major_version == 1 ? 2 : 4);
+            if (preamble_size + header_size > array.size())
+            {
+                throw std::runtime_error("'" + file_name + "' is truncated.");
+            }
+            std::string_view header = array.substr(preamble_size, header_size);
+
+            NpyHeader result;
+            result.data_offset = preamble_size + header_size;
+
+            // 'descr': '<f8'
+            std::string_view descr = value_of(header, "descr", file_name);
+            size_t descr_end = descr.size() > 1 ? descr.find(descr[0], 1) : std::string_view::npos;
+            if (descr_end == std::string_view::npos || (descr[0] != '\'' && descr[0] != '\"') || descr_end < 4)
+            {
+                throw std::runtime_error("'" + file_name + "' has a data type that can't be loaded into a DataSet.");
+            }
+            descr = descr.substr(1, descr_end - 1);
+
+            char byte_order = descr[0];
+            result.kind = descr[1];
+            result.item_size = 0;
+            for (size_t i = 2; i < descr.size(); ++i)
+            {
+                if (descr[i] < '0' || descr[i] > '9')
+                {
+                    throw std::runtime_error("'" + file_name + "' has a data type that can't be loaded into a DataSet.");
+                }
+                result.item_size = result.item_size * 10 + (descr[i] - '0');
+            }
+
+            bool kind_supported = (result.kind == 'f' && (result.item_size == 4 || result.item_size == 8))
+                || ((result.kind == 'i' || result.kind == 'u') && (result.item_size == 1 || result.item_size == 2
+                    || result.item_size == 4 || result.item_size == 8))
+                || (result.kind == 'b' && result.item_size == 1);
+            if (!kind_supported)
+            {
+                throw std::runtime_error("'" + file_name + "' has data type '" + std::string(descr) + "', only numbers and bools can be loaded.");
+            }
+
+            bool file_little_endian = byte_order == '<' || (byte_order != '>' && is_little_endian());
+            result.swapped_byte_order = result.item_size > 1 && file_little_endian != is_little_endian();
+
+            // 'fortran_order': False
+            result.fortran_order = value_of(header, "fortran_order", file_name).substr(0, 4) == "True";
+
+            // 'shape': (3, 4)
+            std::string_view shape = value_of(header, "shape", file_name);
+            size_t shape_end = shape.find(')');
+            if (shape.empty() || shape[0] != '(' || shape_end == std::string_view::npos)
+            {
+                throw std::runtime_error("'" + file_name + "' has a malformed .npy header.");
+            }
+            size_t dimension = 0;
+            bool has_digits = false;
+            for (size_t i = 1; i <= shape_end; ++i)
+            {
+                if (shape[i] >= '0' && shape[i] <= '9')
+                {
+                    dimension = dimension * 10 + (shape[i] - '0');
+                    has_digits = true;
+                }
+                else if (has_digits && (shape[i] == ',' || shape[i] == ')'))
+                {
+                    result.shape.push_back(dimension);
+                    dimension = 0;
+                    has_digits = false;
+                }
+            }
+
+            return result;
+        }
+
+        // the .npy bytes of an array stored in an uncompressed .npz archive.
+        // array_name may leave out the ".npy" suffix, an empty name picks the first array
+        static std::string_view find_npz_array(std::string_view archive, std::string const& array_name, std::string const& file_name)
+        {
+            std::vector<ZipEntry> entries = read_zip_entries(archive, file_name);
+
+            for (ZipEntry const& entry : entries)
+            {
+                if (!array_name.empty() && entry.name != array_name && entry.name != array_name + ".npy")
+                {
+                    continue;
+                }
+
+                if (entry.method != 0)
+                {
+                    throw std::runtime_error("'" + entry.name + "' in '" + file_name
+                        + "' is compressed (np.savez_compressed), only uncompressed .npz files are supported.");
+                }
+
+                uint64_t position = entry.local_header_offset;
+                if (position + 30 > archive.size() || read_le(archive.data() + position, 4) != 0x04034b50)
+                {
+                    throw std::runtime_error("'" + file_name + "' is not a valid .npz archive.");
+                }
+
+                uint64_t data_offset = position + 30 + read_le(archive.data() + position + 26, 2) + read_le(archive.data() + position + 28, 2);
+                if (data_offset + entry.uncompressed_size > archive.size())
+                {
+                    throw std::runtime_error("'" + file_name + "' is truncated.");
+                }
+
+                return archive.substr(data_offset, entry.uncompressed_size);
+            }
+
+            throw std::invalid_argument("'" + file_name + "' has no array named '" + array_name + "'.");
+        }
+
+        // write a zip archive holding a single stored (uncompressed) file,
+        // whose contents are header followed by payload_size bytes at payload
+        static void write_zip(std::string const& file_name, std::string const& entry_name,
+                              std::string const& header, const char *payload, size_t payload_size)
+        {
+            uint64_t entry_size = header.size() + payload_size;
+            if (entry_size >= 0xFFFFFFFF)
+            {
+                throw std::invalid_argument("Arrays of 4 GiB or more can't be written to .npz files, use to_npy() instead.");
+            }
+
+            std::ofstream ofile(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (ofile.fail())
+            {
+                throw std::runtime_error("Could not open '" + file_name + "' for writing.");
+            }
+
+            uint32_t crc = crc32(0, header.data(), header.size());
+            crc = crc32(crc, payload, payload_size);
+
+            // fields shared by the local header and the central directory:
+            // version needed, flags, method (stored), time, date (1980-01-01), crc, sizes, name length
+            std::string common;
+            write_le(common, 20, 2);
+            write_le(common, 0, 2);
+            write_le(common, 0, 2);
+            write_le(common, 0, 2);
+            write_le(common, 0x21, 2);
+            write_le(common, crc, 4);
+            write_le(common, entry_size, 4);
+            write_le(common, entry_size, 4);
+            write_le(common, entry_name.size(), 2);
+
+            // pad the local header with an extra field so the array data starts on a multiple of 64 bytes
+            // (header is a multiple of 64 bytes long) and can be memory mapped without copying
+            size_t padding = (64 - (30 + entry_name.size()) % 64) % 64;
+            if (padding > 0 && padding < 4) { padding += 64; }
+
+            std::string local_header;
+            write_le(local_header, 0x04034b50, 4);
+            local_header += common;
+            write_le(local_header, padding, 2);
+            local_header += entry_name;
+            if (padding > 0)
+            {
+                // 0xD935 is the id zipalign uses for alignment padding
+                write_le(local_header, 0xD935, 2);
+                write_le(local_header, padding - 4, 2);
+                local_header.append(padding - 4, '\0');
+            }
+
+            std::string directory;
+            write_le(directory, 0x02014b50, 4);
+            write_le(directory, 20, 2);
+            directory += common;
+            // extra length, comment length, disk number, internal and external attributes, local header offset
+            write_le(directory, 0, 2);
+            write_le(directory, 0, 2);
+            write_le(directory, 0, 2);
+            write_le(directory, 0, 2);
+            write_le(directory, 0, 4);
+            write_le(directory, 0, 4);
+            directory += entry_name;
+
+            uint64_t directory_offset = local_header.size() + entry_size;
+            if (directory_offset >= 0xFFFFFFFF)
+            {
+                throw std::invalid_argument("Arrays of 4 GiB or more can't be written to .npz files, use to_npy() instead.");
+            }
+
+            std::string end_record;
+            write_le(end_record, 0x06054b50, 4);
+            write_le(end_record, 0, 2);
+            write_le(end_record, 0, 2);
+            write_le(end_record, 1, 2);
+            write_le(end_record, 1, 2);
+            write_le(end_record, directory.size(), 4);
+            write_le(end_record, directory_offset, 4);
+            write_le(end_record, 0, 2);
+
+            ofile.write(local_header.data(), local_header.size());
+            ofile.write(header.data(), header.size());
+            ofile.write(payload, payload_size);
+            ofile.write(directory.data(), directory.size());
+            ofile.write(end_record.data(), end_record.size());
+            ofile.close();
+
+            if (ofile.fail())
+            {
+                throw std::runtime_error("Could not write to '" + file_name + "'.");
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef NUMBERPARSER_HPP
+#define NUMBERPARSER_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+// Converts text to numbers with std::from_chars: no allocations, no locale and no exceptions
+// unless the caller asks for them. Accepts the same input std::stod/std::stoi accepted before:
+// leading whitespace and a '+' sign are skipped and anything after the number is ignored
+// (so "3.5" read as an integer is 3 and a trailing '\r' is harmless).
+class NumberParser
+{
+    private:
+        static bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        }
+
+    public:
+        // empty or whitespace only text, which is read as a missing (null) value
+        static bool is_blank(std::string_view text)
+        {
+            for (char c : text)
+            {
+                if (!is_space(c)) { return false; }
+            }
+            return true;
+        }
+
+        // returns std::errc() on success, std::errc::invalid_argument if no number was found
+        // and std::errc::result_out_of_range if it doesn't fit in X
+        template <typename X>
+        static std::errc parse(std::string_view text, X &value)
+        {
+            const char *first = text.data();
+            const char *last = text.data() + text.size();
+
+            while (first < last && is_space(*first)) { ++first; }
+            if (first < last && *first == '+') { ++first; }
+
+            std::from_chars_result result;
+            if constexpr (std::is_floating_point_v<X>)
+            {
+                result = std::from_chars(first, last, value, std::chars_format::general);
+            }
+            else
+            {
+                result = std::from_chars(first, last, value);
+            }
+
+            return result.ec;
+        }
+
+        // true if the whole text (apart from surrounding whitespace) is a number that fits in X.
+        // Stricter than parse(), which ignores anything after the number
+        template <typename X>
+        static bool is_number(std::string_view text)
+        {
+            const char *first = text.data();
+            const char *last = text.data() + text.size();
+
+            while (first < last && is_space(*first)) { ++first; }
+            while (last > first && is_space(*(last - 1))) { --last; }
+            if (first < last && *first == '+') { ++first; }
+
+            X value{};
+            std::from_chars_result result;
+            if constexpr (std::is_floating_point_v<X>)
+            {
+                result = std::from_chars(first, last, value, std::chars_format::general);
+            }
+            else
+            {
+                result = std::from_chars(first, last, value);
+            }
+
+            return first < last && result.ec == std::errc() && result.ptr == last;
+        }
+
+        // parse text or throw, naming the cell that could not be converted
+        template <typename X>
+        static X parse_cell(std::string_view text, size_t row, size_t column)
+        {
+            X value{};
+            std::errc error = parse<X>(text, value);
+
+            if (error == std::errc::result_out_of_range)
+            {
+                throw std::out_of_range("Value '" + std::string(text) + "' at row " + std::to_string(row)
+                    + ", column " + std::to_string(column) + " is out of range for the requested type.");
+            }
+            else if (error != std::errc())
+            {
+                throw std::invalid_argument("Could not convert '" + std::string(text) + "' at row " + std::to_string(row)
+                    + ", column " + std::to_string(column) + " to a number.");
+            }
+
+            return value;
+        }
+
+        // parse text or throw when the position of the value is not known
+        template <typename X>
+        static X parse_value(std::string_view text)
+        {
+            X value{};
+            std::errc error = parse<X>(text, value);
+
+            if (error == std::errc::result_out_of_range)
+            {
+                throw std::out_of_range("Value '" + std::string(text) + "' is out of range for the requested type.");
+            }
+            else if (error != std::errc())
+            {
+                throw std::invalid_argument("Could not convert '" + std::string(text) + "' to a number.");
+            }
+
+            return value;
+        }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <vector>
+#include <thread>
+#include <exception>
+#include <cstddef>
+#include <algorithm>
+
+// Splitting the rows of a data set between threads (e.g, to group them in group_by()).
+// The rows are cut into contiguous ranges that run on one thread each, so every range can build a partial
+// result of its own (e.g, its groups or its bucket counts) that is combined in range order afterwards.
+//
+//     parallel_ranges(rows, parallel_range_count(rows, n_threads), [&](size_t range, size_t first, size_t last) { ... });
+
+// data sets with fewer rows aren't worth starting threads for
+inline constexpr size_t PARALLEL_ROWS = 1 << 16;
+
+// number of ranges to split n rows into on up to n_threads threads (0 uses every hardware thread).
+// Every range gets at least a quarter of PARALLEL_ROWS rows
+inline size_t parallel_range_count(size_t n, size_t n_threads)
+{
+    if (n_threads == 0) { n_threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+    return n < PARALLEL_ROWS ? 1 : std::max<size_t>(1, std::min(n_threads, n / (PARALLEL_ROWS / 4)));
+}
+
+// run body(range, first, last) for n_ranges ranges of [0, n), one thread per range (a single range runs on
+// the calling thread). The first exception of a range is rethrown once every thread has finished
+template <class Body>
+void parallel_ranges(size_t n, size_t n_ranges, Body body)
+{
+    if (n_ranges <= 1)
+    {
+        body(0, 0, n);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(n_ranges);
+    std::vector<std::thread> workers;
+    for (size_t range = 0; range < n_ranges; ++range)
+    {
+        workers.emplace_back([&, range]()
+        {
+            try { body(range, n * range / n_ranges, n * (range + 1) / n_ranges); }
+            catch (...) { errors[range] = std::current_exception(); }
+        });
+    }
+    for (std::thread &worker : workers) { worker.join(); }
+    for (std::exception_ptr &error : errors)
+    {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef SORTBY_HPP
+#define SORTBY_HPP
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DataSet.hpp"
+#include "Parallel.hpp"
+
+// The row order that sorts a data set by one or more columns, each ascending or descending.
+// The sort is stable (rows with the same keys keep their order), and null values (and NaN) come last
+// whatever the direction.
+// Numeric columns are sorted with an LSD radix sort: the columns are taken from the last key to the first,
+// every value is mapped to an unsigned key that sorts the same way, and the keys are sorted 11 bits at a time
+// (skipping the digits that are the same in every row). Every pass counts the digits of a chunk of rows
+// per thread, then moves the chunks to their places on the same threads.
+// Text (and long double) columns are sorted with a merge sort: chunks of rows are sorted on separate threads,
+// then merged pairwise.
+//
+//     std::vector<size_t> order = SortBy<double>(mydata, {0, 2}, {true, false}).order();
+template <class T>
+class SortBy
+{
+    private:
+        static constexpr size_t RADIX_BITS = 11, BUCKETS = 1 << RADIX_BITS;
+
+        // the values that map to unsigned keys (long double doesn't fit in 64 bits)
+        static constexpr bool radix_sortable = std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+        // bits of the unsigned key of a value
+        static constexpr size_t KEY_BITS = radix_sortable ? 8 * sizeof(T) : 64;
+
+        DataSet<T> const *data;
+        std::vector<size_t> columns;
+        std::vector<bool> ascending;
+
+        T const& cell(size_t row, size_t column) const
+        {
+            return data->data[data->cell_index(row, column)];
+        }
+
+        bool is_null(size_t row, size_t column) const
+        {
+            if constexpr (is_text_type_v<T>)
+            {
+                return cell(row, column).empty();
+            }
+            else
+            {
+                if (!data->cell_is_valid(row, column)) { return true; }
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    T const& value = cell(row, column);
+                    if (value != value) { return true; }
+                }
+                return false;
+            }
+        }
+
+        // an unsigned key that sorts like the value: the sign bit of integers is flipped, and the bits of
+        // negative floating point numbers are all flipped (positive ones only get their sign bit set).
+        // Descending keys are flipped once more
+        static uint64_t radix_key(T value, bool ascending)
+        {
+            uint64_t key = 0;
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                key = value;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                key = (std::make_unsigned_t<T>)value;
+                if constexpr (std::is_signed_v<T>) { key ^= (uint64_t)1 << (KEY_BITS - 1); }
+            }
+            else if constexpr (radix_sortable)
+            {
+                // -0.0 sorts with 0.0, like they compare
+                if (value == 0) { value = 0; }
+                std::memcpy(&key, &value, sizeof(T));
+                uint64_t sign = (uint64_t)1 << (KEY_BITS - 1);
+                key = (key & sign) != 0 ? ~key : key | sign;
+            }
+
+            if (!ascending) { key = ~key; }
+            return KEY_BITS == 64 ? key : key & (((uint64_t)1 << KEY_BITS) - 1);
+        }
+
+        // the key of null cells, past every value when the keys are narrower than 64 bits.
+        // 64-bit integers use every key, their null values need a pass of their own
+        static constexpr uint64_t NULL_KEY = KEY_BITS == 64 ? ~(uint64_t)0 : (uint64_t)1 << KEY_BITS;
+
+        // one stable counting sort pass of order (and keys) by bucket(i) < n_buckets. Every chunk counts its
+        // buckets (unless a single chunk's counts are known already), then the chunks move their rows to
+        // offsets laid out bucket by bucket and chunk by chunk
+        template <class Bucket>
+        static void counting_pass(std::vector<size_t> &order, std::vector<uint64_t> &keys, std::vector<size_t> &order_buffer,
+                                  std::vector<uint64_t> &key_buffer, size_t n_buckets, size_t n_chunks, Bucket bucket,
+                                  const size_t *known_counts = nullptr)
+        {
+            size_t n = order.size();
+            std::vector<size_t> offsets(n_chunks * n_buckets, 0);
+            if (n_chunks == 1 && known_counts != nullptr)
+            {
+                std::copy(known_counts, known_counts + n_buckets, offsets.begin());
+            }
+            else
+            {
+                parallel_ranges(n, n_chunks, [&](size_t chunk, size_t first, size_t last)
+                {
+                    size_t *counts = offsets.data() + chunk * n_buckets;
+                    for (size_t i = first; i < last; ++i) { counts[bucket(i)] += 1; }
+                });
+            }
+
+            size_t offset = 0;
+            for (size_t b = 0; b < n_buckets; ++b)
+            {
+                for (size_t chunk = 0; chunk < n_chunks; ++chunk)
+                {
+                    size_t count = offsets[chunk * n_buckets + b];
+                    offsets[chunk * n_buckets + b] = offset;
+                    offset += count;
+                }
+            }
+
+            parallel_ranges(n, n_chunks, [&](size_t chunk, size_t first, size_t last)
+            {
+                size_t *next = offsets.data() + chunk * n_buckets;
+                for (size_t i = first; i < last; ++i)
+                {
+                    size_t target = next[bucket(i)]++;
+                    order_buffer[target] = order[i];
+                    key_buffer[target] = keys[i];
+                }
+            });
+
+            order.swap(order_buffer);
+            keys.swap(key_buffer);
+        }
+
+        std::vector<size_t> radix_order(size_t n_threads) const
+        {
+            size_t n = data->rows, n_chunks = parallel_range_count(n, n_threads);
+            constexpr size_t n_digits = (64 + RADIX_BITS - 1) / RADIX_BITS;
+
+            std::vector<size_t> order(n), order_buffer(n);
+            std::iota(order.begin(), order.end(), (size_t)0);
+            std::vector<uint64_t> keys(n), key_buffer(n);
+
+            // the last key column is sorted first, every other one keeps the order of the columns after it
+            for (size_t c = columns.size(); c-- > 0;)
+            {
+                size_t column = columns[c];
+                bool column_ascending = ascending[c];
+
+                // the keys in the current order, with how often every digit occurs
+                std::vector<size_t> histograms(n_chunks * n_digits * BUCKETS, 0);
+                parallel_ranges(n, n_chunks, [&](size_t chunk, size_t first, size_t last)
+                {
+                    size_t *histogram = histograms.data() + chunk * n_digits * BUCKETS;
+                    // the cells are read in a loop of their own, so the reads in the permuted order overlap
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        keys[i] = is_null(order[i], column) ? NULL_KEY : radix_key(cell(order[i], column), column_ascending);
+                    }
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        uint64_t key = keys[i];
+                        for (size_t d = 0; d < n_digits; ++d)
+                        {
+                            histogram[d * BUCKETS + ((key >> (d * RADIX_BITS)) & (BUCKETS - 1))] += 1;
+                        }
+                    }
+                });
+
+                for (size_t d = 0; d < n_digits; ++d)
+                {
+                    // a digit that is the same in every row doesn't change the order
+                    bool same_digit = false;
+                    for (size_t b = 0; b < BUCKETS && !same_digit; ++b)
+                    {
+                        size_t count = 0;
+                        for (size_t chunk = 0; chunk < n_chunks; ++chunk) { count += histograms[(chunk * n_digits + d) * BUCKETS + b]; }
+                        same_digit = count == n;
+                    }
+                    if (same_digit) { continue; }
+
+                    size_t shift = d * RADIX_BITS;
+                    counting_pass(order, keys, order_buffer, key_buffer, BUCKETS, n_chunks,
+                                  [&](size_t i) { return (size_t)((keys[i] >> shift) & (BUCKETS - 1)); },
+                                  histograms.data() + d * BUCKETS);
+                }
+
+                // the null cells of 64-bit integers share their key with the largest value
+                if constexpr (KEY_BITS == 64 && std::is_integral_v<T>)
+                {
+                    if (column < data->validity.size() && !data->validity[column].empty())
+                    {
+                        counting_pass(order, keys, order_buffer, key_buffer, 2, n_chunks,
+                                      [&](size_t i) { return (size_t)is_null(order[i], column); });
+                    }
+                }
+            }
+
+            return order;
+        }
+
+        // rows a before b: the first key column that differs decides, null values last
+        bool row_before(size_t a, size_t b) const
+        {
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                bool a_null = is_null(a, columns[c]), b_null = is_null(b, columns[c]);
+                if (a_null || b_null)
+                {
+                    if (a_null != b_null) { return b_null; }
+                    continue;
+                }
+
+                T const& a_value = cell(a, columns[c]);
+                T const& b_value = cell(b, columns[c]);
+                if (a_value < b_value) { return ascending[c]; }
+                if (b_value < a_value) { return !ascending[c]; }
+            }
+            return false;
+        }
+
+        std::vector<size_t> merge_order(size_t n_threads) const
+        {
+            size_t n = data->rows, n_chunks = parallel_range_count(n, n_threads);
+            auto before = [this](size_t a, size_t b) { return row_before(a, b); };
+
+            std::vector<size_t> order(n), order_buffer(n);
+            std::iota(order.begin(), order.end(), (size_t)0);
+            std::vector<size_t> bounds(n_chunks + 1);
+            for (size_t chunk = 0; chunk <= n_chunks; ++chunk) { bounds[chunk] = n * chunk / n_chunks; }
+
+            parallel_ranges(n, n_chunks, [&](size_t, size_t first, size_t last)
+            {
+                std::stable_sort(order.begin() + first, order.begin() + last, before);
+            });
+
+            // merge neighbouring runs until one is left (std::merge takes equal rows from the first run first)
+            while (bounds.size() > 2)
+            {
+                size_t n_merges = (bounds.size() - 1) / 2;
+                std::vector<size_t> merged_bounds;
+                for (size_t m = 0; m < n_merges; ++m) { merged_bounds.push_back(bounds[2 * m]); }
+                if ((bounds.size() - 1) % 2 == 1)
+                {
+                    // an odd run out is copied as it is
+                    merged_bounds.push_back(bounds[bounds.size() - 2]);
+                    std::copy(order.begin() + bounds[bounds.size() - 2], order.end(), order_buffer.begin() + bounds[bounds.size() - 2]);
+                }
+                merged_bounds.push_back(n);
+
+                parallel_ranges(n_merges, n_merges, [&](size_t m, size_t, size_t)
+                {
+                    std::merge(order.begin() + bounds[2 * m], order.begin() + bounds[2 * m + 1],
+                               order.begin() + bounds[2 * m + 1], order.begin() + bounds[2 * m + 2],
+                               order_buffer.begin() + bounds[2 * m], before);
+                });
+
+                order.swap(order_buffer);
+                bounds = std::move(merged_bounds);
+            }
+
+            return order;
+        }
+
+    public:
+        // ascending has one direction per column, or is empty to sort every column ascending
+        SortBy(DataSet<T> const& data, std::vector<size_t> columns, std::vector<bool> ascending = {})
+            : data{&data}, columns{std::move(columns)}, ascending{std::move(ascending)}
+        {
+            if (this->columns.empty())
+            {
+                throw std::invalid_argument("sort_by() needs at least one column.");
+            }
+            if (this->ascending.empty())
+            {
+                this->ascending.assign(this->columns.size(), true);
+            }
+            if (this->ascending.size() != this->columns.size())
+            {
+                throw std::invalid_argument("sort_by() needs one direction per column (or none to sort ascending).");
+            }
+            for (size_t y : this->columns)
+            {
+                if (y >= data.columns)
+                {
+                    throw std::out_of_range("Column " + std::to_string(y) + " is out of range for a data set with "
+                        + std::to_string(data.columns) + " columns.");
+                }
+            }
+        }
+
+        // the rows in sorted order (row i of the sorted data set is row order()[i]),
+        // on n_threads threads for large data sets (0 uses every hardware thread)
+        std::vector<size_t> order(size_t n_threads = 0) const
+        {
+            if constexpr (radix_sortable) { return radix_order(n_threads); }
+            else { return merge_order(n_threads); }
+        }
+};
+
+#endif
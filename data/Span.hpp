@@ -0,0 +1,123 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// A non-owning view of count elements that are stride elements apart (std::span is C++20 and has no
+// stride). In a row-major DataSet rows are contiguous spans (stride 1) and columns are strided spans
+// over the same storage (the other way around for column-major data), so neither copies any cells.
+// NOTE: a span is only valid until the data it points to is resized or destroyed.
+//
+//     Span<const double> row = mydata.row_span(0);
+//     for (double value : row) { ... }
+template <class T>
+class Span
+{
+    private:
+        T *first = nullptr;
+        size_t count = 0;
+        size_t stride = 1;
+
+    public:
+        // iterators keep an index rather than a pointer, so end() of a strided span doesn't point past the storage
+        class iterator
+        {
+            private:
+                T *first = nullptr;
+                std::ptrdiff_t index = 0;
+                size_t stride = 1;
+
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = std::remove_cv_t<T>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = T *;
+                using reference = T &;
+
+                iterator() {}
+                iterator(T *first, difference_type index, size_t stride) : first{first}, index{index}, stride{stride} {}
+
+                reference operator*() const { return first[index * (difference_type)stride]; }
+                pointer operator->() const { return &first[index * (difference_type)stride]; }
+                reference operator[](difference_type n) const { return first[(index + n) * (difference_type)stride]; }
+
+                iterator &operator++() { ++index; return *this; }
+                iterator operator++(int) { iterator previous = *this; ++index; return previous; }
+                iterator &operator--() { --index; return *this; }
+                iterator operator--(int) { iterator previous = *this; --index; return previous; }
+                iterator &operator+=(difference_type n) { index += n; return *this; }
+                iterator &operator-=(difference_type n) { index -= n; return *this; }
+                iterator operator+(difference_type n) const { return iterator(first, index + n, stride); }
+                iterator operator-(difference_type n) const { return iterator(first, index - n, stride); }
+                difference_type operator-(iterator const& other) const { return index - other.index; }
+
+                bool operator==(iterator const& other) const { return index == other.index; }
+                bool operator!=(iterator const& other) const { return index != other.index; }
+                bool operator<(iterator const& other) const { return index < other.index; }
+                bool operator>(iterator const& other) const { return index > other.index; }
+                bool operator<=(iterator const& other) const { return index <= other.index; }
+                bool operator>=(iterator const& other) const { return index >= other.index; }
+        };
+
+        Span() {}
+
+        Span(T *first, size_t count, size_t stride = 1) : first{first}, count{count}, stride{stride} {}
+
+        // a contiguous span over a whole vector (with any allocator, e.g, std::pmr::vector)
+        template <class Alloc>
+        Span(std::vector<std::remove_cv_t<T>, Alloc> &values) : first{values.data()}, count{values.size()} {}
+
+        template <class Alloc, class U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+        Span(std::vector<std::remove_cv_t<T>, Alloc> const& values) : first{values.data()}, count{values.size()} {}
+
+        // Span<T> converts to Span<const T>
+        template <class U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+        Span(Span<U> const& other) : first{other.data()}, count{other.size()}, stride{other.get_stride()} {}
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        T *data() const
+        {
+            return first;
+        }
+
+        // distance between consecutive elements (1 for contiguous spans)
+        size_t get_stride() const
+        {
+            return stride;
+        }
+
+        T &operator[](size_t i) const
+        {
+            return first[i * stride];
+        }
+
+        iterator begin() const
+        {
+            return iterator(first, 0, stride);
+        }
+
+        iterator end() const
+        {
+            return iterator(first, (std::ptrdiff_t)count, stride);
+        }
+
+        // copy the elements into a vector
+        std::vector<std::remove_cv_t<T>> to_vector() const
+        {
+            return std::vector<std::remove_cv_t<T>>(begin(), end());
+        }
+};
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Transposes matrices of cells stored one row after the other.
+// The matrix is walked in BLOCK x BLOCK tiles so reads and writes both stay within a few cache lines,
+// and inside a tile 8 byte cells (double, size_t, ...) are transposed 4x4 (AVX) or 2x2 (SSE2) in registers,
+// 4 byte cells (float, int, ...) 4x4 (SSE). Other cells, or builds without SSE2, use a scalar loop.
+// Pick the instruction set at compile time (e.g, -mavx2).
+// Large matrices are split into bands of tiles that are transposed on separate threads.
+class Transpose
+{
+    public:
+        // a BLOCK x BLOCK tile of doubles (8KB) fits in L1 cache
+        static constexpr size_t BLOCK = 32;
+
+        // matrices with fewer cells aren't worth starting threads for
+        static constexpr size_t PARALLEL_CELLS = 1 << 20;
+
+    private:
+        template <class T>
+        static constexpr bool is_simd_cell_v = std::is_trivially_copyable_v<T> && (sizeof(T) == 8 || sizeof(T) == 4);
+
+        // width of the in-register kernel for T (1 without a kernel)
+        template <class T>
+        static constexpr size_t kernel_size()
+        {
+            if constexpr (!is_simd_cell_v<T>) { return 1; }
+#if defined(__AVX__)
+            else if constexpr (sizeof(T) == 8) { return 4; }
+#elif defined(__SSE2__)
+            else if constexpr (sizeof(T) == 8) { return 2; }
+#endif
+#if defined(__SSE2__)
+            else if constexpr (sizeof(T) == 4) { return 4; }
+#endif
+            else { return 1; }
+        }
+
+        // transpose the kernel_size() x kernel_size() block at source into target
+        // (the registers only shuffle bits, so integer cells are loaded as floating point lanes)
+        template <class T>
+        static void transpose_kernel(const T *source, size_t source_stride, T *target, size_t target_stride)
+        {
+            constexpr size_t K = kernel_size<T>();
+            if constexpr (K == 1)
+            {
+                *target = *source;
+            }
+#if defined(__AVX__)
+            else if constexpr (sizeof(T) == 8)
+            {
+                const double *s = reinterpret_cast<const double *>(source);
+                double *t = reinterpret_cast<double *>(target);
+                __m256d r0 = _mm256_loadu_pd(s);
+                __m256d r1 = _mm256_loadu_pd(s + source_stride);
+                __m256d r2 = _mm256_loadu_pd(s + 2 * source_stride);
+                __m256d r3 = _mm256_loadu_pd(s + 3 * source_stride);
+                __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+                __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+                __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+                __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+                _mm256_storeu_pd(t, _mm256_permute2f128_pd(t0, t2, 0x20));
+                _mm256_storeu_pd(t + target_stride, _mm256_permute2f128_pd(t1, t3, 0x20));
+                _mm256_storeu_pd(t + 2 * target_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+                _mm256_storeu_pd(t + 3 * target_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+            }
+#elif defined(__SSE2__)
+            else if constexpr (sizeof(T) == 8)
+            {
+                const double *s = reinterpret_cast<const double *>(source);
+                double *t = reinterpret_cast<double *>(target);
+                __m128d r0 = _mm_loadu_pd(s);
+                __m128d r1 = _mm_loadu_pd(s + source_stride);
+                _mm_storeu_pd(t, _mm_unpacklo_pd(r0, r1));
+                _mm_storeu_pd(t + target_stride, _mm_unpackhi_pd(r0, r1));
+            }
+#endif
+#if defined(__SSE2__)
+            else if constexpr (sizeof(T) == 4)
+            {
+                const float *s = reinterpret_cast<const float *>(source);
+                float *t = reinterpret_cast<float *>(target);
+                __m128 r0 = _mm_loadu_ps(s);
+                __m128 r1 = _mm_loadu_ps(s + source_stride);
+                __m128 r2 = _mm_loadu_ps(s + 2 * source_stride);
+                __m128 r3 = _mm_loadu_ps(s + 3 * source_stride);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(t, r0);
+                _mm_storeu_ps(t + target_stride, r1);
+                _mm_storeu_ps(t + 2 * target_stride, r2);
+                _mm_storeu_ps(t + 3 * target_stride, r3);
+            }
+#endif
+        }
+
+        // transpose rows [row_begin, row_end) x columns [column_begin, column_end) of source into target.
+        // Source rows are source_stride cells apart, target rows target_stride cells apart
+        template <bool Move, class T>
+        static void transpose_tile(T *source, size_t source_stride, T *target, size_t target_stride,
+                                   size_t row_begin, size_t row_end, size_t column_begin, size_t column_end)
+        {
+            constexpr size_t K = kernel_size<T>();
+            size_t i = row_begin;
+            if constexpr (K > 1)
+            {
+                for (; i + K <= row_end; i += K)
+                {
+                    size_t j = column_begin;
+                    for (; j + K <= column_end; j += K)
+                    {
+                        transpose_kernel(source + i * source_stride + j, source_stride, target + j * target_stride + i, target_stride);
+                    }
+                    for (; j < column_end; ++j)
+                    {
+                        for (size_t k = i; k < i + K; ++k)
+                        {
+                            target[j * target_stride + k] = source[k * source_stride + j];
+                        }
+                    }
+                }
+            }
+
+            // rows left over from the kernels (every row for cells without a kernel)
+            for (; i < row_end; ++i)
+            {
+                for (size_t j = column_begin; j < column_end; ++j)
+                {
+                    if constexpr (Move) { target[j * target_stride + i] = std::move(source[i * source_stride + j]); }
+                    else { target[j * target_stride + i] = source[i * source_stride + j]; }
+                }
+            }
+        }
+
+        // transpose every tile of the bands of rows [band_begin, band_end)
+        template <bool Move, class T>
+        static void transpose_bands(T *source, T *target, size_t rows, size_t columns, size_t band_begin, size_t band_end)
+        {
+            for (size_t band = band_begin; band < band_end; ++band)
+            {
+                size_t row_begin = band * BLOCK;
+                size_t row_end = std::min(row_begin + BLOCK, rows);
+                for (size_t column_begin = 0; column_begin < columns; column_begin += BLOCK)
+                {
+                    transpose_tile<Move>(source, columns, target, rows, row_begin, row_end,
+                                         column_begin, std::min(column_begin + BLOCK, columns));
+                }
+            }
+        }
+
+        // run job(first, last) over n_tasks tasks split into contiguous ranges on n_threads threads
+        template <class Job>
+        static void run_split(size_t n_tasks, size_t n_threads, Job job)
+        {
+            n_threads = std::max<size_t>(1, std::min(n_threads, n_tasks));
+            if (n_threads == 1)
+            {
+                job(0, n_tasks);
+                return;
+            }
+
+            std::vector<std::thread> workers;
+            size_t per_thread = (n_tasks + n_threads - 1) / n_threads;
+            for (size_t first = 0; first < n_tasks; first += per_thread)
+            {
+                workers.emplace_back(job, first, std::min(first + per_thread, n_tasks));
+            }
+            for (std::thread &worker : workers) { worker.join(); }
+        }
+
+        // number of threads to use for a matrix (n_threads = 0 uses every hardware thread)
+        static size_t thread_count(size_t cells, size_t n_threads)
+        {
+            if (cells < PARALLEL_CELLS) { return 1; }
+            if (n_threads == 0) { n_threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+
+            return n_threads;
+        }
+
+        template <bool Move, class T>
+        static void transpose_matrix(T *source, T *target, size_t rows, size_t columns, size_t n_threads)
+        {
+            size_t bands = (rows + BLOCK - 1) / BLOCK;
+            run_split(bands, thread_count(rows * columns, n_threads), [&](size_t first, size_t last)
+            {
+                transpose_bands<Move>(source, target, rows, columns, first, last);
+            });
+        }
+
+        // swap tile (rows, columns) with the transpose of the mirrored tile (columns, rows).
+        // A tile on the diagonal is its own mirror
+        template <class T>
+        static void swap_tiles(T *cells, size_t n, std::vector<T> &buffer,
+                               size_t row_begin, size_t row_end, size_t column_begin, size_t column_end)
+        {
+            size_t tile_rows = row_end - row_begin, tile_columns = column_end - column_begin;
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                // tile -> buffer (transposed, tile_columns x tile_rows)
+                T *tile = cells + row_begin * n + column_begin;
+                transpose_tile<false>(tile, n, buffer.data(), tile_rows, 0, tile_rows, 0, tile_columns);
+                if (row_begin != column_begin)
+                {
+                    // mirrored tile -> tile
+                    T *mirror = cells + column_begin * n + row_begin;
+                    transpose_tile<false>(mirror, n, tile, n, 0, tile_columns, 0, tile_rows);
+                    // buffer -> mirrored tile
+                    for (size_t i = 0; i < tile_columns; ++i)
+                    {
+                        std::copy(buffer.data() + i * tile_rows, buffer.data() + (i + 1) * tile_rows, mirror + i * n);
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < tile_rows; ++i)
+                    {
+                        std::copy(buffer.data() + i * tile_rows, buffer.data() + (i + 1) * tile_rows, tile + i * n);
+                    }
+                }
+            }
+            else
+            {
+                using std::swap;
+                for (size_t i = row_begin; i < row_end; ++i)
+                {
+                    // on the diagonal only swap the cells above it
+                    for (size_t j = row_begin == column_begin ? i + 1 : column_begin; j < column_end; ++j)
+                    {
+                        swap(cells[i * n + j], cells[j * n + i]);
+                    }
+                }
+            }
+        }
+
+    public:
+        // copy the rows x columns matrix in source into target (columns x rows)
+        template <class T>
+        static void copy(const T *source, T *target, size_t rows, size_t columns, size_t n_threads = 1)
+        {
+            transpose_matrix<false>(const_cast<T *>(source), target, rows, columns, n_threads);
+        }
+
+        // like copy(), but cells are moved out of source (cheaper for text cells)
+        template <class T>
+        static void move(T *source, T *target, size_t rows, size_t columns, size_t n_threads = 1)
+        {
+            transpose_matrix<true>(source, target, rows, columns, n_threads);
+        }
+
+        // transpose the n x n matrix in cells without a second matrix.
+        // Tiles above the diagonal swap places with the mirrored tiles below it (through a tile sized
+        // buffer, so the register kernels are used), every band of tiles can run on its own thread
+        template <class T>
+        static void in_place(T *cells, size_t n, size_t n_threads = 1)
+        {
+            size_t bands = (n + BLOCK - 1) / BLOCK;
+            size_t threads = std::max<size_t>(1, std::min(thread_count(n * n, n_threads), bands));
+
+            // bands near the top hold more tiles, so threads take every threads-th band instead of a range
+            run_split(threads, threads, [&](size_t first, size_t last)
+            {
+                for (size_t thread_n = first; thread_n < last; ++thread_n)
+                {
+                    std::vector<T> buffer;
+                    if constexpr (std::is_trivially_copyable_v<T>) { buffer.resize(BLOCK * BLOCK); }
+
+                    for (size_t band = thread_n; band < bands; band += threads)
+                    {
+                        size_t row_begin = band * BLOCK;
+                        size_t row_end = std::min(row_begin + BLOCK, n);
+                        for (size_t column_begin = row_begin; column_begin < n; column_begin += BLOCK)
+                        {
+                            size_t column_end = std::min(column_begin + BLOCK, n);
+                            swap_tiles(cells, n, buffer, row_begin, row_end, column_begin, column_end);
+                        }
+                    }
+                }
+            });
+        }
+};
+
+#endif
@@ -21,5 +21,20 @@ int main()
     DataSet<std::string> appended_columns = sub1.append(sub2, 'c');
     appended_columns.head();
 
+    // grow a data set in place, e.g, to collect batches of predictions.
+    // Rows are added with geometric growth, so this takes linear time overall
+    DataSet<std::string> collected;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        collected.append_rows(sub1);
+    }
+    collected.append_row({"a", "b"});
+
+    // temporary data sets are moved instead of copied
+    collected.append_rows(sub2.append(sub2, 'r'));
+
+    // add columns in place (the names must be new)
+    sub1.append_columns(sub2);
+
     return 0;
 }
\ No newline at end of file
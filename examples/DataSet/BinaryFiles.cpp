@@ -0,0 +1,32 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    // parsing a large CSV file over and over again is slow, so after loading it once
+    // it can be saved in a binary format that is loaded without any parsing
+    DataSet<double> mydata("example_data.csv");
+    mydata.save_binary("example_data.bin");
+
+    // by default the file is memory mapped: the data set points straight into the file,
+    // so this returns immediately regardless of the file size. Modifying the data set
+    // never changes the file.
+    DataSet<double> cached;
+    cached.load_binary("example_data.bin");
+    cached.head();
+
+    // pass memory_map = false to copy the data into memory instead
+    DataSet<double> copied;
+    copied.load_binary("example_data.bin", false);
+
+    // text data sets work the same way (std::string_view cells point into the file)
+    DataSet<std::string> mytext("example_data.csv");
+    mytext.save_binary("example_text.bin");
+
+    DataSet<std::string_view> cached_text;
+    cached_text.load_binary("example_text.bin");
+
+    // the type must match the one the file was saved with
+    // (e.g, loading example_data.bin into DataSet<int> throws std::invalid_argument)
+
+    return 0;
+}
@@ -26,5 +26,16 @@ int main()
     DataSet<double> mydata_double = mydata.cast<double>();
     mydata_double.head();
 
+    // cells that aren't numbers throw std::invalid_argument with the row and column
+    // of the cell, e.g: "Could not convert 'abc' at row 4, column 2 to a number."
+    try
+    {
+        DataSet<int> mydata_int = mydata.cast<int>();
+    }
+    catch (std::invalid_argument const& e)
+    {
+        std::cout << e.what() << "\n";
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    /*
+    Arithmetic on columns is lazy: mydata.expr("x") * 2.0 doesn't compute anything,
+    it describes the computation. assign() then evaluates the whole expression
+    in one loop over the rows and writes the result into a column, so no
+    temporary column is created for the intermediate steps.
+    */
+
+    DataSet<double> mydata(6, 2);
+    mydata.set_column_names({"price", "quantity"});
+    for (size_t i = 0; i < 6; ++i)
+    {
+        mydata.set(i, 0, 1.5 * (i + 1));
+        mydata.set(i, 1, 10.0 - i);
+    }
+
+    // new columns are added after the last one
+    mydata.assign("total", mydata.expr("price") * mydata.expr("quantity") + 2.0);
+
+    // existing columns are overwritten, and can be used in their own expression
+    mydata.assign("price", mydata.expr("price") * 1.2);
+
+    // log, exp, sqrt, abs, pow and clip work on whole columns
+    mydata.assign("log_total", clip(log(mydata.expr("total")), 0.0, 3.0));
+
+    // comparisons give 1 or 0, and where() picks between two values row by row
+    mydata.assign("bulk", mydata.expr("quantity") >= 8);
+    mydata.assign("discount", where(mydata.expr("total") > 20 && mydata.expr("bulk") == 1, mydata.expr("total") * 0.1, 0.0));
+
+    mydata.head();
+
+    // a cell computed from a null cell is null
+    mydata.set_null(2, 1);
+    mydata.assign("total", mydata.expr("price") * mydata.expr("quantity"));
+    mydata.head();
+
+    // columns can be referenced by index too, and an expression can be evaluated into a vector
+    std::vector<double> doubled = (mydata.expr(0) * 2).evaluate(mydata.count_rows());
+    std::cout << "First doubled price: " << doubled[0] << "\n";
+
+    return 0;
+}
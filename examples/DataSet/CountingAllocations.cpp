@@ -0,0 +1,82 @@
+#include <iostream>
+#include <new>
+#include <cstdlib>
+#include "data/DataSet.hpp"
+#include "models/classification/DecisionTree.hpp"
+#include "models/classification/KNN.hpp"
+
+// count every heap allocation of the program by replacing the global operator new
+// (operator new[] and the standard containers allocate through it as well)
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) { return pointer; }
+    throw std::bad_alloc();
+}
+
+// GCC can't tell that these pointers came from the malloc() above once operator new is inlined
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// heap allocations made while calling f
+template <class F>
+size_t count_allocations(F f)
+{
+    size_t before = allocations;
+    f();
+    return allocations - before;
+}
+
+int main()
+{
+    /*
+    Models read rows and columns through spans (see row_span() and column_span()),
+    so predict() doesn't copy every row it looks at into a new vector.
+    This counts the heap allocations of predict() on the same data set twice
+    (n rows, then 2n rows): the allocations per row are the difference between
+    both calls divided by n, what's left is a fixed cost (e.g, the output data set,
+    whose vector grows geometrically so twice the rows can take one more allocation).
+    */
+
+    DataSet<double> full_data("datasets/small_classification_test.csv");
+
+    std::vector<std::string> target = {"target"};
+    DataSet<double> xdata = full_data.drop<double>(target);
+    DataSet<size_t> ydata = full_data.select<size_t>(target);
+    DataSet<double> xdata_twice = xdata.append(xdata, 'r');
+    size_t n = xdata.count_rows();
+
+    // before: reading every row as a vector allocates once per row
+    size_t copied_rows = count_allocations([&]() {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) { sum += xdata.get_row(i)[0]; }
+        std::cout << "sum of the first column: " << sum << '\n';
+    });
+    std::cout << "get_row() loop:        " << (double)copied_rows / n << " allocations per row\n";
+
+    // after: predict() reads the rows as spans
+    DecisionTree dt;
+    dt.fit(xdata, ydata);
+    size_t dt_once = count_allocations([&]() { dt.predict(xdata); });
+    size_t dt_twice = count_allocations([&]() { dt.predict(xdata_twice); });
+    std::cout << "DecisionTree::predict: " << (double)(dt_twice - dt_once) / n << " allocations per row ("
+              << dt_once << " for " << n << " rows)\n";
+
+    KNN knn(5);
+    knn.fit(xdata, ydata);
+    size_t knn_once = count_allocations([&]() { knn.predict(xdata); });
+    size_t knn_twice = count_allocations([&]() { knn.predict(xdata_twice); });
+    std::cout << "KNN::predict:          " << (double)(knn_twice - knn_once) / n << " allocations per row ("
+              << knn_once << " for " << n << " rows)\n";
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "data/DataSet.hpp"
+#include "data/DataSetView.hpp"
+#include "models/classification/DecisionTree.hpp"
+
+int main()
+{
+    /*
+    A DataSetView is a lightweight window into a DataSet: a list of rows and
+    a list of columns of its parent. Selecting, dropping and filtering a view
+    doesn't copy any cells, which makes it cheap to carve up a data set many
+    times (e.g, for cross validation or random forests).
+
+    The parent DataSet must stay alive while the view is used, and writing to
+    a cell through a view changes the parent.
+    */
+
+    DataSet<double> mydata("datasets/small_classification_test.csv");
+
+    // a view of the whole data set
+    DataSetView<double> all_rows(mydata);
+
+    // select/drop columns by index or name, get rows by index
+    std::vector<std::string> target_col = {"target"};
+    DataSetView<double> features = all_rows.drop(target_col);
+    DataSetView<double> first_rows = features.get_rows({0, 1, 2});
+
+    // filter rows with the same conditions as DataSet::filter()
+    DataSetView<double> positive = features.filter([](std::vector<double> row) { return row[0] > 0; });
+    std::cout << positive.count_rows() << " rows have a positive first column.\n";
+
+    // copy the viewed cells into a new data set when needed
+    first_rows.materialize().head();
+
+    // rows and columns can be read as spans without copying them into a vector
+    // (columns are strided over row-major storage, rows over column-major storage)
+    double row_sum = 0;
+    for (double value : mydata.row_span(0)) { row_sum += value; }
+    Span<const double> first_column = mydata.column_span(0);
+    std::cout << "first row sums to " << row_sum << ", first column has " << first_column.size() << " values.\n";
+
+    // views hand out spans into the parent when their rows/columns are contiguous there,
+    // otherwise the cells are gathered into a buffer that can be reused between calls
+    std::vector<double> buffer;
+    double features_sum = 0;
+    for (size_t i = 0; i < features.count_rows(); ++i)
+    {
+        Span<const double> row = features.row_span(i, buffer);
+        for (double value : row) { features_sum += value; }
+    }
+    std::cout << "features sum to " << features_sum << ".\n";
+
+    // models take views directly (a DataSet converts to a view of all its cells)
+    DataSet<size_t> target = mydata.select<size_t>(target_col);
+    DecisionTree dt;
+    dt.fit(features, target);
+    DataSet<size_t> preds = dt.predict(first_rows);
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    /*
+    describe() prints summary statistics of every column: the sum, min, max,
+    mean, standard deviation and the 10th, 25th, 50th, 75th and 90th
+    percentiles. It also returns them as a DataSet<double> with one row per
+    statistic (in that order) and one column per column of the data set.
+    Null values are left out of the statistics.
+    */
+
+    DataSet<double> mydata("datasets/small_regression_test.csv");
+    mydata.describe();
+
+    // the statistics can be used without printing them (row 3 holds the means)
+    DataSet<double> summary = mydata.describe(false);
+    std::cout << "Mean of the first column: " << summary(3, 0) << "\n";
+
+    // large data sets are summarized a few columns per thread (0 uses every hardware thread)
+    mydata.describe(false, 2);
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include "data/EncodedDataSet.hpp"
+
+int main()
+{
+    // EncodedDataSet stores every distinct value of a column once and each cell as a small
+    // integer code, which saves a lot of memory for columns with repeated values (categories)
+    EncodedDataSet mydata("example_data.csv");
+    std::cout << "Distinct values in column 0: " << mydata.count_categories(0) << std::endl;
+
+    // filter conditions are checked once per distinct value instead of once per row
+    EncodedDataSet filtered = mydata.filter(0, [](std::string const& value) { return value == "some text"; });
+
+    // or keep the rows that have given values in some columns
+    EncodedDataSet matching = mydata.filter({{mydata.column_names[0], "some text"}});
+
+    // replace(), replacena() and select() work the same as for DataSet<std::string>
+    mydata.replacena("NA", true);
+    mydata.replace("some text", "other text", true);
+    EncodedDataSet subset = mydata.select(std::vector<size_t>{0});
+    subset.to_csv("export_test.csv");
+
+    // convert from and to DataSet<std::string>
+    DataSet<std::string> text_data = mydata.decode();
+    EncodedDataSet encoded_again(text_data);
+
+    return 0;
+}
@@ -33,5 +33,29 @@ int main()
     // otherwise, for ad-hoc filters it's cleaner to defined it within the
     // filter() scope like the second approach.
 
+    // conditions on columns can also be written as filter expressions. They are
+    // evaluated one column at a time into a bitmap of the kept rows, which is much
+    // faster than calling a lambda (with a copy of the row) for every row.
+    // Columns are picked by name (FilterColumn::named) or by index (FilterColumn::at), and combined with &&, || and !
+    mydata.filter(FilterColumn::named("col1") == "a" || FilterColumn::named("col2") == "e").head();
+
+    mydata.filter(!(FilterColumn::at(2).in({"c", "f"}))).head();
+
+    // numeric columns compare with numbers, and null cells never match a condition
+    DataSet<double> numbers(5, 2);
+    numbers.set_column_names({"x", "y"});
+    for (size_t i = 0; i < 5; ++i)
+    {
+        numbers.set(i, 0, i);
+        numbers.set(i, 1, 10.0 * i);
+    }
+    numbers.set_null(3, 1);
+
+    numbers.filter(FilterColumn::named("x") >= 1 && FilterColumn::named("y").between(10, 40)).head();
+
+    // like the lambda version, inplace = true filters the DataSet itself
+    numbers.filter(FilterColumn::named("x").in({0, 2, 4}), true);
+    numbers.head();
+
     return 0;
 }
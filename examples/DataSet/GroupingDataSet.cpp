@@ -0,0 +1,50 @@
+#include "data/DataSet.hpp"
+#include "data/EncodedDataSet.hpp"
+
+int main()
+{
+    /*
+    group_by() splits the rows of a data set by the values of one or more key
+    columns, and agg() computes sums, means, minimums, maximums, variances and
+    counts of other columns for every group. The result is a new data set with
+    one row per group: the keys first, then one column per aggregation.
+    */
+
+    DataSet<double> sales(8, 3);
+    sales.set_column_names({"store", "units", "price"});
+    double stores[] = {1, 2, 1, 3, 2, 1, 3, 2};
+    double units[] = {4, 7, 2, 9, 1, 5, 3, 8};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        sales.set(i, 0, stores[i]);
+        sales.set(i, 1, units[i]);
+        sales.set(i, 2, 2.5 + 0.5 * i);
+    }
+
+    // groups are listed in the order they first appear
+    DataSet<double> per_store = sales.group_by({"store"}).agg({{"units", Aggregation::Sum},
+                                                                {"units", Aggregation::Mean},
+                                                                {"price", Aggregation::Max},
+                                                                {"price", Aggregation::Var}});
+    per_store.head();
+
+    // null values are not aggregated, and rows with a null key are left out
+    sales.set_null(0, 1);
+    sales.set_null(7, 0);
+    sales.group_by({"store"}).agg({{"units", Aggregation::Count}, {"units", Aggregation::Min}}).head();
+
+    // count() gives the number of rows of every group
+    sales.group_by({0}).count().head();
+
+    // text keys are grouped through their dictionary codes
+    DataSet<std::string> city_names(4, 1);
+    city_names.set_column_names({"city"});
+    city_names.set(0, 0, "Lima");
+    city_names.set(1, 0, "Oslo");
+    city_names.set(2, 0, "Lima");
+    city_names.set(3, 0, "Lima");
+    EncodedDataSet cities(city_names);
+    cities.get_codes().group_by({"city"}).count().head();
+
+    return 0;
+}
@@ -5,16 +5,12 @@ int main()
     /*
     This shows some functions for checking/replacing null values.
 
-    One caveat to this, if your data includes null (blank) values, it
-    MUST be loaded as std::string. Trying to load null values with
-    double/integer types will lead to errors as it won't be able to
-    convert a blank value to a double/int.
-
-    After removing/replacing null values, you can then cast the data set
-    to a double/int type.
+    Null (blank or missing) values can be loaded with any type. Text data
+    sets keep them as empty strings, numeric data sets keep a bitmap per
+    column marking which values are present, so nulls don't need to be
+    removed before loading as double/int.
     */
 
-    // if your data contains null values, it MUST be loaded as std::string !!
     DataSet<std::string> mydata("small_classification_test.csv");
 
     // count null columns and print to console
@@ -45,5 +41,23 @@ int main()
     DataSet<std::string> mydata_replaced = mydata.replacena("not null anymore");
     mydata_replaced.head();
 
+    // numeric data sets load blank values as nulls (printed as NA)
+    DataSet<double> numeric_data("small_classification_test.csv");
+    numeric_data.countna();
+
+    // check or set single null values
+    bool first_is_null = numeric_data.is_null(0, 0);
+    std::cout << "first cell is " << (first_is_null ? "null" : "not null") << '\n';
+    numeric_data.set_null(0, 1);
+
+    // the same functions work on numeric data sets, the replacement is
+    // parsed as the data set type
+    DataSet<double> numeric_dropped = numeric_data.dropna();
+    DataSet<double> numeric_replaced = numeric_data.replacena("0");
+    numeric_replaced.head();
+
+    // nulls are written back as blank values
+    numeric_data.to_csv("with_nulls.csv");
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    /*
+    join() matches the rows of two data sets on key columns, like a SQL join.
+    The result has the columns of the first data set, then the columns of the
+    second one without its keys. An inner join keeps the rows that match, a left
+    join keeps every row of the first data set (with null values where nothing
+    matches).
+    */
+
+    DataSet<double> features(5, 3);
+    features.set_column_names({"id", "height", "weight"});
+    for (size_t i = 0; i < 5; ++i)
+    {
+        features.set(i, 0, i + 1);
+        features.set(i, 1, 150.0 + 5 * i);
+        features.set(i, 2, 50.0 + 4 * i);
+    }
+
+    DataSet<double> labels(4, 2);
+    labels.set_column_names({"id", "label"});
+    double ids[] = {4, 1, 2, 9};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        labels.set(i, 0, ids[i]);
+        labels.set(i, 1, i % 2);
+    }
+
+    // rows come out in the order of the first data set
+    features.join(labels, {"id"}).head();
+    features.join(labels, {"id"}, JoinType::Left).head();
+
+    // key columns can have different names (or be given by index), and there can be several of them
+    labels.set_column_names({"patient", "label"});
+    features.join(labels, {"id"}, {"patient"}, JoinType::Left).head();
+    features.join(labels, {0}, {0}).head();
+
+    // the sort-merge join is the fastest when both data sets are already sorted by their keys
+    // (it sorts them otherwise, and gives the same rows as the hash join)
+    features.join(labels, {"id"}, {"patient"}, JoinType::Inner, JoinMethod::SortMerge).head();
+
+    return 0;
+}
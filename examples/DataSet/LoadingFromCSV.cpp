@@ -29,5 +29,19 @@ int main()
     // parameters: filename, sep = ",", headers = true
     mydata_other.load("example_data.csv", "|", false);
 
+    // large files can be parsed on several threads (same parameters as load() plus the
+    // number of threads, where 0 = use all hardware threads)
+    DataSet<double> mydata_parallel;
+    mydata_parallel.load_parallel("example_data.csv", ",", true, 8);
+
+#ifdef CPPEZML_USE_ZLIB
+    // gzip support is optional: compile with -DCPPEZML_USE_ZLIB and link with -lz.
+    // to_csv() compresses the output when the file name ends with ".gz"
+    mydata_parallel.to_csv("export_test.csv.gz");
+
+    // gzip compressed files are detected and decompressed while loading (no temporary file)
+    DataSet<double> mydata_gzip("export_test.csv.gz");
+#endif
+
     return 0;
 }
\ No newline at end of file
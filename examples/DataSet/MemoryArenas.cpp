@@ -0,0 +1,44 @@
+#include "data/DataSet.hpp"
+#include "data/DataSetView.hpp"
+
+int main()
+{
+    /*
+    A DataSet allocates its cells from a std::pmr::memory_resource, the default heap unless
+    another one is passed when it's created. A DataArena pools the memory of short-lived
+    data sets (and std::pmr containers) and frees all of it at once, which is how
+    DecisionTree::fit() handles the temporaries of growing a tree.
+
+    Nothing allocated from an arena may outlive it. Copies of a data set always use the
+    default heap, a data set that is moved keeps its memory resource.
+    */
+
+    DataSet<double> mydata("datasets/small_classification_test.csv");
+
+    {
+        DataArena arena;
+
+        // a temporary copy of some rows, allocated from the arena
+        DataSetView<double> first_rows = DataSetView<double>(mydata).get_rows({0, 1, 2});
+        DataSet<double> scratch = first_rows.materialize(Layout::ColumnMajor, arena.resource());
+
+        // empty data sets can be filled later (loading, appending, ...)
+        DataSet<double> batches(arena.resource());
+        batches.append_rows(scratch);
+
+        // standard containers can use the arena as well
+        std::pmr::vector<size_t> row_indices(arena.resource());
+
+        // copies are safe to keep after the arena is gone
+        DataSet<double> kept = scratch;
+    } // everything allocated from the arena is freed here
+
+    // large buffers can be backed by transparent huge pages (Linux), which cuts down on
+    // TLB misses when a data set of hundreds of MB is scanned (kept small here)
+    DataSet<double> big(10000, 50, Layout::RowMajor, HugePageResource::get());
+
+    // arenas can take their large blocks from huge pages too
+    DataArena huge_arena(true);
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    // DataSet<std::string_view> memory maps the file instead of copying every cell into
+    // its own std::string. Each cell is a view into the file, which stays mapped as long as
+    // the data set (or any data set created from it with select(), filter(), etc.) is alive.
+    DataSet<std::string_view> mydata("example_data.csv");
+    mydata.head();
+
+    // modifying cells with set() (or replace(), replacena(), ...) copies the new text
+    // into the data set, so it's safe to pass temporary strings
+    std::string new_value = "some text";
+    mydata.set(0, 0, new_value);
+
+    // converting to numeric types or to std::string works the same as for DataSet<std::string>
+    DataSet<double> mydata_double = mydata.select<double>(std::vector<size_t>{1, 2});
+    DataSet<std::string> mydata_string = mydata.cast<std::string>();
+
+    // other types can also be parsed straight from the mapped file
+    DataSet<double> mapped_double;
+    mapped_double.load_mmap("example_data.csv");
+
+    return 0;
+}
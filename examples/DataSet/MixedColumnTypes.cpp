@@ -0,0 +1,22 @@
+#include "data/MixedDataSet.hpp"
+
+int main()
+{
+    // MixedDataSet parses every column of a file straight into its final type: numeric columns
+    // go into a DataSet<double>, text columns into a DataSet<std::string>.
+    // Without a schema, the column types are guessed from the first rows of the file
+    MixedDataSet<double> mydata("example_data.csv");
+    mydata.numeric.head();
+    mydata.text.head();
+
+    // or pass one ColumnType per column of the file
+    std::vector<ColumnType> schema = mydata.infer_schema("example_data.csv");
+    schema[0] = ColumnType::Text;
+    MixedDataSet<double> typed_data("example_data.csv", schema);
+
+    // column 0 of the file is now the first column of typed_data.text
+    std::cout << "Column 0 is stored at position " << typed_data.get_column_position(0)
+              << " of " << (typed_data.get_column_type(0) == ColumnType::Text ? "text" : "numeric") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    // arrays saved from Python with np.save() can be loaded directly (1D arrays become one column).
+    // If the array has the same type as the data set, the file is memory mapped and used without
+    // copying (Fortran order arrays are kept column-major); other dtypes are converted while loading
+    DataSet<double> features;
+    features.load_npy("features.npy");
+    features.head();
+
+    // uncompressed archives from np.savez() work as well, pick an array by its keyword
+    // (arrays passed by position are named "arr_0", "arr_1", ...)
+    DataSet<float> labels;
+    labels.load_npz("training.npz", "labels");
+
+    // pass memory_map = false to copy the data into memory instead
+    DataSet<double> copied;
+    copied.load_npy("features.npy", false);
+
+    // write data sets for np.load() (column names are not stored)
+    features.to_npy("features_out.npy");
+    features.to_npz("features_out.npz", "features");
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "data/DataSet.hpp"
+
+int main()
+{
+    /*
+    sort_by() sorts the rows of a data set by one or more columns, each one
+    ascending or descending. Rows with the same values keep their order (the
+    sort is stable), and null values come last.
+    */
+
+    DataSet<double> sales(7, 3);
+    sales.set_column_names({"store", "day", "revenue"});
+    double stores[] = {2, 1, 2, 1, 3, 1, 2};
+    double revenue[] = {120.5, 98.0, 87.25, 143.0, 60.0, 98.0, 150.75};
+    for (size_t i = 0; i < 7; ++i)
+    {
+        sales.set(i, 0, stores[i]);
+        sales.set(i, 1, i + 1);
+        sales.set(i, 2, revenue[i]);
+    }
+    sales.set_null(4, 2);
+
+    // by store, then by revenue from the largest to the smallest
+    sales.sort_by({"store", "revenue"}, {true, false}).head();
+
+    // columns can be given by index
+    sales.sort_by({2}, {false}).head();
+
+    // the row order alone (row i of the sorted data set is row order[i])
+    std::vector<size_t> order = sales.sort_order({2});
+    std::cout << "Cheapest day: " << sales(order[0], 1) << "\n";
+
+    // sorting inplace moves the rows into place instead of copying the data set
+    sales.sort_by({"revenue"}, {}, true);
+    sales.head();
+
+    // text columns are sorted too
+    DataSet<std::string> names(4, 1);
+    names.set_column_names({"name"});
+    names.set(0, 0, "Oslo");
+    names.set(1, 0, "Lima");
+    names.set(2, 0, "Rome");
+    names.set(3, 0, "Kyiv");
+    names.sort_by({"name"}).head();
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "data/DataSet.hpp"
+#include "data/DataSetView.hpp"
+
+int main()
+{
+    /*
+    A DataSet stores its cells row by row by default (Layout::RowMajor), which suits
+    code that reads whole rows (e.g, distances between points). Code that scans whole
+    columns (e.g, statistics per feature, tree splits) reads contiguous memory when the
+    cells are stored column by column instead (Layout::ColumnMajor).
+
+    The layout only changes how cells are stored: indexing, rows, columns and every
+    other method work the same on both layouts.
+    */
+
+    DataSet<double> mydata("datasets/small_classification_test.csv");
+
+    // convert the storage in place (a cache-blocked transpose of the cells)
+    mydata.set_layout(Layout::ColumnMajor);
+    if (mydata.get_layout() == Layout::ColumnMajor)
+    {
+        // columns are now contiguous spans, rows are strided
+        double column_sum = 0;
+        for (double value : mydata.column_span(0)) { column_sum += value; }
+        std::cout << "Sum of the first column: " << column_sum << "\n";
+    }
+
+    // new data sets can be created column-major
+    DataSet<double> scores(100, 3, Layout::ColumnMajor);
+
+    // views can be copied into the layout that suits how the copy will be read
+    DataSetView<double> first_rows = DataSetView<double>(mydata).get_rows({0, 1, 2});
+    DataSet<double> row_copy = first_rows.materialize(Layout::RowMajor);
+
+    // binary files keep the layout, and NumPy arrays saved in Fortran order (e.g, np.asfortranarray)
+    // load as column-major data without reordering the cells
+    mydata.save_binary("column_major.bin");
+    mydata.to_npy("column_major.npy");
+
+    DataSet<double> loaded;
+    loaded.load_binary("column_major.bin");
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include "data/DataSetReader.hpp"
+
+int main()
+{
+    // DataSetReader reads a CSV file a few rows at a time, so files that don't fit in memory
+    // can still be processed. Batches are parsed by a background thread while the current
+    // batch is being used.
+    DataSetReader<double> reader("example_data.csv", 100);
+    std::cout << "Columns: " << reader.count_columns() << std::endl;
+
+    DataSet<double> batch;
+    double total = 0;
+    while (reader.next(batch))
+    {
+        // every batch is a regular DataSet with the file's column names
+        std::vector<double> first_column = batch.get_column(0);
+        for (double value : first_column)
+        {
+            total += value;
+        }
+    }
+
+    std::cout << "Read " << reader.rows_read() << " rows, the first column adds up to " << total << std::endl;
+
+    return 0;
+}
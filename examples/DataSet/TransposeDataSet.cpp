@@ -13,5 +13,12 @@ int main()
     // transposed data (assignment)
     DataSet<std::string> transposed_data = mydata.transpose();
 
+    // large data sets are transposed on several threads (0 = every hardware thread, the default)
+    DataSet<double> numeric_data("small_classification_test.csv");
+    DataSet<double> single_threaded = numeric_data.transpose(1);
+
+    // transpose without keeping the original (square data sets swap their cells in place)
+    numeric_data.transpose_inplace();
+
     return 0;
 }
\ No newline at end of file
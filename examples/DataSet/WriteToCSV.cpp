@@ -15,5 +15,9 @@ int main()
     // here, we write with delimiter "|" and don't print the column headers
     mydata.to_csv("export_test.csv", "|", false);
 
+    // large data sets can be formatted on several threads (0 = use every hardware thread),
+    // the rows are still written in order
+    mydata_numeric.to_csv("export_test.csv", ",", true, 0);
+
     return 0;
 }
\ No newline at end of file
@@ -3,20 +3,22 @@
 #include <vector>
 #include <iostream>
 #include "../data/DataSet.hpp"
+#include "../data/DataSetView.hpp"
 #include "../stats/Stats.hpp"
-// Base class for all classifiers. Contains metrics and such that's common among all models
+// Base class for all classifiers. Contains metrics and such that's common among all models.
+// Models take DataSetViews, so a DataSet or any subset of one (e.g, a cross validation fold) is passed without copying
 class Classifier
 {
 public:
     // all classes must implement a predict() and fit() method
     virtual void fit(
-        DataSet<double> &,   // data
-        DataSet<size_t> &    // target
+        DataSetView<double>,   // data
+        DataSetView<size_t>    // target
         ) = 0;
 
-    virtual DataSet<size_t> predict(DataSet<double> &) = 0;
+    virtual DataSet<size_t> predict(DataSetView<double>) = 0;
 
-    double get_f1_score(DataSet<size_t> &actual_y, DataSet<size_t> predicted_y)
+    double get_f1_score(DataSetView<size_t> actual_y, DataSet<size_t> predicted_y)
     {
         if (actual_y.count_rows() != predicted_y.count_rows())
         {
@@ -47,29 +49,22 @@ public:
     }
 
     template <typename Model>
-    std::vector<double> monte_carlo_cv(Model *model_pointer, DataSet<double> xdata, DataSet<size_t> ydata, size_t k, double test_ratio = 0.3)
+    std::vector<double> monte_carlo_cv(Model *model_pointer, DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k, double test_ratio = 0.3)
     {
         if (k < 2) { throw std::invalid_argument("k must be at least two for k_fold_cv."); }
         
-        DataSet<double> full_data = xdata.append(ydata.cast<double>(), 'c');
-        DataSet<double> train_data, test_data, train_x, test_x;
-        DataSet<size_t> train_y, test_y;
+        DataSetView<double> train_x, test_x;
+        DataSetView<size_t> train_y, test_y;
 
         std::vector<double> f1_values(k);
         std::vector<double> return_values(2); // 0 = mean of f1 values, 1 = stdev of f1 values
 
-        std::vector<size_t> last_column;
-
         for (size_t fold = 0; fold < k; ++fold)
         {
-            full_data.split_data(test_ratio, train_data, test_data);
-
-            last_column = {full_data.count_columns() - 1};
-            train_x = train_data.drop<double>(last_column);
-            train_y = train_data.select<size_t>(last_column);
-
-            test_x = test_data.drop<double>(last_column);
-            test_y = test_data.select<size_t>(last_column);
+            // folds are views over xdata/ydata, only the row indices are new
+            xdata.split_data(test_ratio, train_x, test_x);
+            train_y = ydata.get_rows(train_x.get_row_indices());
+            test_y = ydata.get_rows(test_x.get_row_indices());
 
             // passing a pointer to capture the constructor parameters from the model
             Model model = *model_pointer;
@@ -1,17 +1,18 @@
 #ifndef CLUSTER_HPP
 #define CLUSTER_HPP
 #include <vector>
+#include "../data/DataSetView.hpp"
 class Cluster {
     private:
 
     public:
         // no labels for clustering algorithms; returns vector with clustered classes
         virtual void fit(
-            DataSet<double> & // data
+            DataSetView<double> // data
         ) = 0;
 
         virtual DataSet<size_t> predict(
-            DataSet<double> & // data
+            DataSetView<double> // data
             ) = 0;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef DISTANCE_HPP
+#define DISTANCE_HPP
+
+#include <vector>
+#include <stdexcept>
+#include <math.h>
+
+#include "../data/Span.hpp"
+
+// distance between two rows for distance based models (KNN, KMeans).
+// Rows are passed as spans, only a custom distance function needs them copied into vectors
+inline double row_distance(
+    Span<const double> x1,
+    Span<const double> x2,
+    double (*custom_distance)(std::vector<double>, std::vector<double>) = NULL
+)
+{
+    if (x1.size() != x2.size())
+    {
+        throw std::invalid_argument("Mismatched sizes when trying to compute distance.");
+    }
+
+    if (custom_distance != NULL)
+    {
+        return custom_distance(x1.to_vector(), x2.to_vector());
+    }
+
+    // Euclidean distance (default)
+    double distance = 0;
+    for (size_t i = 0; i < x1.size(); ++i)
+    {
+        distance += (x1[i] - x2[i]) * (x1[i] - x2[i]);
+    }
+
+    return sqrt(distance);
+}
+
+#endif
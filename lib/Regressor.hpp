@@ -3,22 +3,24 @@
 #include <vector>
 #include <math.h>
 #include "../data/DataSet.hpp"
+#include "../data/DataSetView.hpp"
 #include "../stats/Stats.hpp"
-// Base class for all regressors. Contains metrics and such that's common among all models
+// Base class for all regressors. Contains metrics and such that's common among all models.
+// Models take DataSetViews, so a DataSet or any subset of one (e.g, a cross validation fold) is passed without copying
 class Regressor
 {
 
 public:
     // all classes must implement a predict() and fit() method
     virtual void fit(
-        DataSet<double> &, // data
-        DataSet<double> &  // target
+        DataSetView<double>, // data
+        DataSetView<double>  // target
         ) = 0;
 
-    virtual DataSet<double> predict(DataSet<double> &) = 0;
+    virtual DataSet<double> predict(DataSetView<double>) = 0;
 
     // root mean squared error
-    double get_rmse(DataSet<double> &actual_y, DataSet<double> predicted_y)
+    double get_rmse(DataSetView<double> actual_y, DataSet<double> predicted_y)
     {
         double sum = 0;
         for (int i = 0; i < actual_y.count_rows(); ++i)
@@ -30,27 +32,22 @@ public:
     }
 
     template <typename Model>
-    std::vector<double> monte_carlo_cv(Model *model_pointer, DataSet<double> xdata, DataSet<double> ydata, size_t k, double test_ratio = 0.3)
+    std::vector<double> monte_carlo_cv(Model *model_pointer, DataSetView<double> xdata, DataSetView<double> ydata, size_t k, double test_ratio = 0.3)
     {
         if (k < 2) { throw std::invalid_argument("k must be at least two for k_fold_cv."); }
         
-        DataSet<double> full_data = xdata.append(ydata, 'c');
-        DataSet<double> train_data, test_data, train_x, test_x, train_y, test_y;
+        DataSetView<double> train_x, test_x;
+        DataSetView<double> train_y, test_y;
 
         std::vector<double> rmse_values(k);
         std::vector<double> return_values(2); // 0 = mean of rmse values, 1 = stdev of rmse values
 
-        std::vector<size_t> last_column;
         for (size_t fold = 0; fold < k; ++fold)
         {
-            full_data.split_data(test_ratio, train_data, test_data);
-
-            last_column = {full_data.count_columns() - 1};
-            train_x = train_data.drop<double>(last_column);
-            train_y = train_data.select<double>(last_column);
-
-            test_x = test_data.drop<double>(last_column);
-            test_y = test_data.select<double>(last_column);
+            // folds are views over xdata/ydata, only the row indices are new
+            xdata.split_data(test_ratio, train_x, test_x);
+            train_y = ydata.get_rows(train_x.get_row_indices());
+            test_y = ydata.get_rows(test_x.get_row_indices());
 
             // passing a pointer to capture constructor paramters from model
             Model model = *model_pointer;
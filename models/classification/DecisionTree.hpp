@@ -6,8 +6,10 @@
 #include <math.h>
 #include <stdexcept>
 #include <memory>
+#include <memory_resource>
 
 #include "../../lib/Classifier.hpp"
+#include "../../data/DataArena.hpp"
 
 class Node
 {
@@ -15,7 +17,8 @@ public:
 	std::shared_ptr<Node> left;
 	std::shared_ptr<Node> right;
 
-	DataSet<double> data;
+	// number of training rows that reached this node
+	size_t sample_count = 0;
 	std::vector<size_t> labels;
 	int feature_index;
 	double split_point;
@@ -51,17 +54,26 @@ private:
 
 	Node root_node; // a copy of the root node so we can deallocate the pointer later on
 
+	// reused by column_median() so growing the tree doesn't allocate a column per split
+	std::vector<double> median_buffer, column_buffer;
+
+	// the label lists of every split are allocated from the DataArena of the current fit()
+	std::pmr::memory_resource *scratch = std::pmr::get_default_resource();
+
 	// utility functions
-	std::vector<size_t> get_unique_labels(std::vector<size_t> labels)
+	template <class Labels>
+	Labels get_unique_labels(Labels const& labels)
 	{
-		std::vector<size_t>::iterator ip;
-		ip = std::unique(labels.begin(), labels.end());
-		labels.resize(std::distance(labels.begin(), ip));
+		// the copy keeps the allocator of labels (e.g, the arena of the current fit())
+		Labels unique_labels(labels, labels.get_allocator());
+		typename Labels::iterator ip;
+		ip = std::unique(unique_labels.begin(), unique_labels.end());
+		unique_labels.resize(std::distance(unique_labels.begin(), ip));
 
-		return labels;
+		return unique_labels;
 	}
 
-	double get_class_proportion(size_t target_class, std::vector<size_t> const &class_labels)
+	double get_class_proportion(size_t target_class, Span<const size_t> class_labels)
 	{
 		double sum = 0;
 		for (int i = 0; i < class_labels.size(); ++i)
@@ -75,13 +87,11 @@ private:
 		return sum / class_labels.size();
 	}
 
-	double entropy(std::vector<size_t> class_labels)
+	double entropy(Span<const size_t> original_class_labels)
 	{
-		// keep original class labels
-		std::vector<size_t> original_class_labels = class_labels;
-
 		// get unique class labels
-		std::vector<size_t>::iterator ip;
+		std::pmr::vector<size_t> class_labels(original_class_labels.begin(), original_class_labels.end(), scratch);
+		std::pmr::vector<size_t>::iterator ip;
 		std::sort(class_labels.begin(), class_labels.end());
 		ip = std::unique(class_labels.begin(), class_labels.end());
 		class_labels.resize(std::distance(class_labels.begin(), ip));
@@ -98,10 +108,12 @@ private:
 		return entropy_sum;
 	}
 
-	double column_median(size_t column_index, DataSet<double> &data)
+	double column_median(size_t column_index, DataSetView<double> const &data)
 	{
 		// tranpose column into row
-		std::vector<double> row_data = data.get_column(column_index);
+		Span<const double> column = data.column_span(column_index, column_buffer);
+		std::vector<double> &row_data = median_buffer;
+		row_data.assign(column.begin(), column.end());
 
 		// sort and compute median
 		double median;
@@ -119,15 +131,15 @@ private:
 		return median;
 	}
 
-	std::vector<double> split_feature(
+	std::pmr::vector<double> split_feature(
 		size_t feature_index, 
-		DataSet<double> &data, 
-		std::vector<size_t> labels, 
+		DataSetView<double> const &data, 
+		Span<const size_t> labels, 
 		char feature_type
 	)
 	{
-		std::vector<size_t> left_labels;
-		std::vector<size_t> right_labels;
+		std::pmr::vector<size_t> left_labels(scratch);
+		std::pmr::vector<size_t> right_labels(scratch);
 		double split_point;
 		double split_entropy;
 		// feature_type = n is numeric
@@ -152,19 +164,19 @@ private:
 		}
 		else if (feature_type == 'c')
 		{
-			std::vector<size_t> temp_left_labels; // going to be resuing these until we find best category label to split on
-			std::vector<size_t> temp_right_labels;
+			std::pmr::vector<size_t> temp_left_labels(scratch); // going to be resuing these until we find best category label to split on
+			std::pmr::vector<size_t> temp_right_labels(scratch);
 
 			// iterate over every unique label and select one that returns minimum entropy (to maximize information gain)
 			// first, transpose column vector into integer row vector and call get_unique_labels
-			std::vector<size_t> unique_category_labels;
+			std::pmr::vector<size_t> unique_category_labels(scratch);
 			for (size_t i = 0; i < data.count_rows(); ++i)
 			{
 				unique_category_labels.push_back((size_t)data(i, feature_index));
 			}
 
 			unique_category_labels = get_unique_labels(unique_category_labels);
-			std::vector<double> category_entropy_list;
+			std::pmr::vector<double> category_entropy_list(scratch);
 			double temp_entropy;
 
 			for (size_t i = 0; i < unique_category_labels.size(); ++i)
@@ -205,7 +217,7 @@ private:
 			split_point = unique_category_labels[best_index];
 		}
 
-		std::vector<double> split_feature_data;
+		std::pmr::vector<double> split_feature_data(scratch);
 		split_feature_data.push_back(split_entropy);
 		split_feature_data.push_back(split_point);
 
@@ -215,8 +227,8 @@ private:
 
 	void grow_tree(
 		std::shared_ptr<Node> tree_node,
-		DataSet<double> &data,
-		std::vector<size_t> labels,
+		DataSetView<double> data,
+		Span<const size_t> labels,
 		size_t max_depth,
 		size_t current_depth,
 		size_t min_samples_split,
@@ -235,7 +247,7 @@ private:
 		// iterate over every feature and grow the tree
 		double info_gain;
 		double split_point;
-		std::vector<double> feature_split;
+		std::pmr::vector<double> feature_split(scratch);
 
 		for (size_t i = 0; i < data.count_columns(); ++i)
 		{
@@ -268,83 +280,52 @@ private:
 			current_depth = max_depth + 1;
 		}
 
-		DataSet<double> left_data;
-		std::vector<size_t> left_labels;
+		// the child nodes see their rows of data through views, no rows are copied
+		std::vector<size_t> left_rows, right_rows;
+		std::pmr::vector<size_t> left_labels(scratch), right_labels(scratch);
 
-		DataSet<double> right_data;
-		std::vector<size_t> right_labels;
-
-		size_t left_data_size = 0, right_data_size = 0;
-
-		// pass through to resize data sets appropriately
 		for (size_t i = 0; i < data.count_rows(); ++i)
 		{
 			if (data(i, feature_to_split) <= split_point)
 			{
-				left_data_size++;
+				left_rows.push_back(i);
+				left_labels.push_back(labels[i]);
 			}
 			else
 			{
-				right_data_size++;
+				right_rows.push_back(i);
+				right_labels.push_back(labels[i]);
 			}
 		}
 
-		left_data.resize(left_data_size, data.count_columns());
-		right_data.resize(right_data_size, data.count_columns());
-
-		std::vector<size_t> labels_vec = labels;
-
-		// a map used to track the current indices when setting data
-		// for left/right nodes
-
-		// key = type (left, right), value = current index
-		std::unordered_map<size_t, size_t> left_right_indices = {
-			{0, 0}, // left = 0 by default
-			{1, 0} // right = 0 by default
-		};
-
-		// add data on second pass through
-		for (size_t i = 0; i < data.count_rows(); ++i)
-		{
-			if (data(i, feature_to_split) <= split_point)
-			{
-				left_data.set_row(left_right_indices[0], data.get_row(i));
-				left_labels.push_back(labels_vec[i]);
-				left_right_indices[0]++;
-			}
-			else
-			{
-				right_data.set_row(left_right_indices[1], data.get_row(i));
-				right_labels.push_back(labels_vec[i]);
-				left_right_indices[1]++;
-			}
-		}
+		DataSetView<double> left_data = data.get_rows(left_rows);
+		DataSetView<double> right_data = data.get_rows(right_rows);
 
 		tree_node->split_point = split_point;
 		tree_node->feature_index = feature_to_split;
 
 		tree_node->left = std::make_shared<Node>();
-		tree_node->left->data = left_data;
-		tree_node->left->labels = left_labels;
+		tree_node->left->sample_count = left_data.count_rows();
+		tree_node->left->labels.assign(left_labels.begin(), left_labels.end());
 
 		tree_node->right = std::make_shared<Node>();
-		tree_node->right->data = right_data;
-		tree_node->right->labels = right_labels;
+		tree_node->right->sample_count = right_data.count_rows();
+		tree_node->right->labels.assign(right_labels.begin(), right_labels.end());
 
-		std::vector<size_t> left_unique = get_unique_labels(left_labels);
-		std::vector<size_t> right_unique = get_unique_labels(right_labels);
+		std::pmr::vector<size_t> left_unique = get_unique_labels(left_labels);
+		std::pmr::vector<size_t> right_unique = get_unique_labels(right_labels);
 
 		if (current_depth < max_depth)
 		{
 			// grow tree in both directions
 			// must have at least two samples to split (could be controlled by parameter)
 			// must have more than one unique label (otherwise it's a perfect leaf node)
-			if (tree_node->left->data.count_rows() > (min_samples_split - 1) && left_unique.size() > 1)
+			if (tree_node->left->sample_count > (min_samples_split - 1) && left_unique.size() > 1)
 			{
 				grow_tree(tree_node->left, left_data, left_labels, max_depth, current_depth + 1, min_samples_split, categorical_columns);
 			}
 
-			if (tree_node->right->data.count_rows() > (min_samples_split - 1) && right_unique.size() > 1)
+			if (tree_node->right->sample_count > (min_samples_split - 1) && right_unique.size() > 1)
 			{
 				grow_tree(tree_node->right, right_data, right_labels, max_depth, current_depth + 1, min_samples_split, categorical_columns);
 			}
@@ -352,7 +333,7 @@ private:
 	}
 
 	// traversing tree when calling predict()
-	size_t predict_down(std::shared_ptr<Node> tree_node, std::vector<double> data)
+	size_t predict_down(std::shared_ptr<Node> const &tree_node, Span<const double> data)
 	{
 		if (tree_node->left == NULL && tree_node->right == NULL)
 		{
@@ -378,8 +359,8 @@ public:
 	std::shared_ptr<Node> root = std::make_shared<Node>();
 
 	void fit(
-		DataSet<double> &data, 
-		DataSet<size_t> &labels
+		DataSetView<double> data, 
+		DataSetView<size_t> labels
 		) override
 	{
 		if (min_samples_split < 2)
@@ -387,18 +368,36 @@ public:
 			throw std::invalid_argument("Please set min_samples_split parameter to at least 2.");
 		}
 
-		grow_tree(root, data, labels.get_column(0), max_depth, 1, min_samples_split, categorical_columns);
+		// the copy of the data and the label lists of every split only live while the tree grows,
+		// they come from one arena that is released when fit() returns
+		DataArena arena;
+		scratch = arena.resource();
+
+		// point scratch back at the default resource when fit() leaves, also if growing the tree throws
+		struct ScratchReset
+		{
+			std::pmr::memory_resource *&scratch;
+			~ScratchReset() { scratch = std::pmr::get_default_resource(); }
+		} reset_scratch{scratch};
+
+		// every split scans whole columns, so grow the tree over a column-major copy of the data
+		DataSet<double> column_data = data.materialize(Layout::ColumnMajor, arena.resource());
+		std::vector<size_t> root_labels = labels.get_column(0);
+
+		root->sample_count = data.count_rows();
+		grow_tree(root, column_data, root_labels, max_depth, 1, min_samples_split, categorical_columns);
 	}
 
-	DataSet<size_t> predict(DataSet<double> &data) override
+	DataSet<size_t> predict(DataSetView<double> data) override
 	{
 
 		std::vector<size_t> predictions;
+		std::vector<double> row_buffer;
 
 		// start at root node and traverse
 		for (size_t i = 0; i < data.count_rows(); ++i)
 		{
-			predictions.push_back(predict_down(root, data.get_row(i)));
+			predictions.push_back(predict_down(root, data.row_span(i, row_buffer)));
 		}
 
 		DataSet<size_t> predictions_data(predictions.size(), 1);
@@ -409,7 +408,7 @@ public:
 		return predictions_data;
 	}
 
-	std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
+	std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
 	{
 		return Classifier::monte_carlo_cv<DecisionTree>(this, xdata, ydata, k, test_ratio);
 	}
@@ -10,10 +10,6 @@
 class GaussianNaiveBayes : public Classifier
 {
     private:
-        // a map that partitions the data set based on the class
-        // key = class, value = DataSet<> for the class
-        std::unordered_map<size_t, DataSet<double>> partitioned_data;
-
         // a map of density estimators based on the class
         // key = class, value = DataSet<> containing mean/sigma estimates for the normal distribution
         // i.e, each row of data set only has two elements: [0] = mu, [1] = sigma
@@ -39,32 +35,21 @@ class GaussianNaiveBayes : public Classifier
 
 
     public:
-        void fit(DataSet<double> &data, DataSet<size_t> &target) override
+        void fit(DataSetView<double> data, DataSetView<size_t> target) override
         {
-            std::unordered_map<size_t, size_t> class_counts;
             unique_classes = get_unique_labels(target.get_column(0));
-            std::unordered_map<size_t, size_t> class_count_iter;
 
-            // count data points per class to resize data sets inside partitioned_data
-            for (size_t i = 0; i < target.count_rows(); ++i)
+            // partition the rows based on class
+            // key = class, value = row indices of the class
+            std::unordered_map<size_t, std::vector<size_t>> class_rows;
+            for (size_t row = 0; row < data.count_rows(); ++row)
             {
-                class_counts[target(i, 0)]++;
+                class_rows[target(row, 0)].push_back(row);
             }
 
-            // resize DataSet<> objects in maps
             for (size_t class_label : unique_classes)
             {
-                partitioned_data[class_label].resize(class_counts[class_label], data.count_columns());
                 density_estimators[class_label].resize(data.count_columns(), 2);
-                // keeps track of the current index of the class when partitioning data
-                class_count_iter[class_label] = 0;
-            }
-
-            // partition the data based on class
-            for (size_t row = 0; row < data.count_rows(); ++row)
-            {
-                partitioned_data[target(row, 0)].set_row(class_count_iter[target(row, 0)], data.get_row(row));
-                class_count_iter[target(row, 0)]++;
             }
 
             // fit density estimators on each class
@@ -74,14 +59,11 @@ class GaussianNaiveBayes : public Classifier
             Stats stats;
             for (size_t classes : unique_classes)
             {
-                for (int col = 0; col < partitioned_data[classes].count_columns(); ++col)
+                DataSetView<double> class_data = data.get_rows(class_rows[classes]);
+                for (size_t col = 0; col < class_data.count_columns(); ++col)
                 {
                     // transpose column data into single vector
-                    column_data.clear();
-                    for (int row = 0; row < partitioned_data[classes].count_rows(); ++row)
-                    {
-                        column_data.push_back(partitioned_data[classes](row, col));
-                    }
+                    column_data = class_data.get_column(col);
                     parameter_estimates.clear();
                     parameter_estimates.push_back(stats.mean(column_data));
                     parameter_estimates.push_back(stats.stdev(column_data));
@@ -91,7 +73,7 @@ class GaussianNaiveBayes : public Classifier
             }
         }
 
-        DataSet<size_t> predict(DataSet<double> &data) override
+        DataSet<size_t> predict(DataSetView<double> data) override
         {
             // vector for the likelihoods of each class
             // NOTE: to avoid the problem of incredibly small values when taking products, using log likelihood instead
@@ -130,7 +112,7 @@ class GaussianNaiveBayes : public Classifier
             return prediction_data;
         }
 
-        std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
+        std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
         {
             return Classifier::monte_carlo_cv<GaussianNaiveBayes>(this, xdata, ydata, k, test_ratio);
         }
@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include "../../lib/Classifier.hpp"
+#include "../../lib/Distance.hpp"
 #include "../../data/DataSet.hpp"
 
 class KNN : public Classifier
@@ -34,37 +35,9 @@ private:
         return labels_copy;
     }
 
-    double get_distance(
-        std::vector<double> x1, 
-        std::vector<double> x2, 
-        double (*custom_distance)(std::vector<double>, std::vector<double>) = NULL
-    )
+    double get_distance(Span<const double> x1, Span<const double> x2)
     {
-
-        if (x1.size() != x2.size())
-        {
-            throw std::invalid_argument("Mismatched sizes when trying to compute distance.");
-        }
-
-        if (has_custom_distance)
-        {
-            return custom_distance(x1, x2);
-        }
-        // default distance (Euclidean)
-        else
-        {
-            double distance = 0;
-
-            for (size_t i = 0; i < x1.size(); ++i)
-            {
-                distance += (x1[i] - x2[i]) * (x1[i] - x2[i]);
-            }
-
-            return sqrt(distance);
-        }
-
-        // technically unreachable but required
-        return 0.0;
+        return row_distance(x1, x2, has_custom_distance ? custom_distance : NULL);
     }
 
     int get_vector_index(std::vector<double> const &vec, double value)
@@ -129,38 +102,28 @@ public:
         }
     }
 
-    void fit(DataSet<double> &data, DataSet<size_t> &target) override
+    void fit(DataSetView<double> data, DataSetView<size_t> target) override
     {
         // first, get unique values of target and partition them in class_data map
         this->unique_target = get_unique_labels(target.get_column(0));
 
-        std::unordered_map<size_t, size_t> class_counts;
-        std::unordered_map<size_t, size_t> class_count_iter;
-
-        // count data points per class to resize data sets inside class_data
-        class_counts.clear();
-        for (size_t i = 0; i < target.count_rows(); ++i)
+        // partition row indices based on class
+        std::unordered_map<size_t, std::vector<size_t>> class_rows;
+        for (size_t i = 0; i < data.count_rows(); ++i)
         {
-            class_counts[target(i, 0)]++;
+            class_rows[target(i, 0)].push_back(i);
         }
 
-        // resize data sets for each class
+        // the training points are kept for predict(), so each class is copied once,
+        // row-major since every distance reads whole rows
+        class_data.clear();
         for (size_t class_label : unique_target)
         {
-            class_data[class_label].resize(class_counts[class_label], data.count_columns());
-            // keeps track of the current index of the class when partitioning data
-            class_count_iter[class_label] = 0;
-        }
-
-        // partition data based on class
-        for (size_t i = 0; i < data.count_rows(); ++i)
-        {
-            class_data[target(i, 0)].set_row(class_count_iter[target(i, 0)], data.get_row(i));
-            class_count_iter[target(i, 0)]++;
+            class_data[class_label] = data.get_rows(class_rows[class_label]).materialize(Layout::RowMajor);
         }
     }
 
-    DataSet<size_t> predict(DataSet<double> &data) override
+    DataSet<size_t> predict(DataSetView<double> data) override
     {
         // iterate over unique class partitions and create distance vectors
         std::vector<size_t> class_vector;
@@ -172,22 +135,30 @@ public:
         size_t common_class, highest_count;
         size_t current_count = 0;
 
+        // the vectors above and this buffer keep their capacity between points,
+        // so after the first point the loop doesn't allocate
+        std::vector<double> point_buffer;
+
         for (size_t current_point = 0; current_point < data.count_rows(); ++current_point)
         {
             // reset
             distance_vector.clear();
             original_distance_vector.clear();
             class_vector.clear();
+            Span<const double> point = data.row_span(current_point, point_buffer);
             for (size_t class_label : unique_target)
             {
-                for (size_t r = 0; r < class_data[class_label].count_rows(); ++r)
+                DataSet<double> &class_points = class_data[class_label];
+                for (size_t r = 0; r < class_points.count_rows(); ++r)
                 {
+                    double distance = get_distance(point, class_points.row_span(r));
+
                     // ignore equivalent point(s)
                     // this is a lazy (and bad) way of excluding the current data point
-                    if (get_distance(data.get_row(current_point), class_data[class_label].get_row(r), this->custom_distance) == 0) { continue; }
+                    if (distance == 0) { continue; }
                     else 
                     {
-                        distance_vector.push_back(get_distance(data.get_row(current_point), class_data[class_label].get_row(r), this->custom_distance));
+                        distance_vector.push_back(distance);
                         class_vector.push_back(class_label); 
                     }
                 }
@@ -217,7 +188,7 @@ public:
         return prediction_data;
     }
 
-    std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
+    std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
 	{
 		return Classifier::monte_carlo_cv<KNN>(this, xdata, ydata, k, test_ratio);
 	}
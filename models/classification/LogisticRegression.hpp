@@ -58,7 +58,7 @@ private:
 	}
 
 	// local predict, not to be confused with the public predict()
-	double predict(std::vector<double> &weights, std::vector<double> input_x_row)
+	double predict(std::vector<double> &weights, Span<const double> input_x_row)
 	{
 
 		double result = 0;
@@ -86,9 +86,9 @@ public:
 		if (loss_func != NULL) { user_loss_func = loss_func; }
 	}
 
-	void fit(DataSet<double> &train_x, DataSet<size_t> &train_y) override
+	void fit(DataSetView<double> train_x, DataSetView<size_t> train_y) override
 	{
-		this->independent_variable_names = train_x.column_names;
+		this->independent_variable_names = train_x.get_column_names();
 
 		// create initial weights equal to size of input columns (# of indep vars)
 		for (size_t col = 0; col < train_x.count_columns(); ++col)
@@ -104,6 +104,11 @@ public:
 		size_t iter = 0;
 		double prediction, loss_derivative;
 
+		// the weights only change at the end of an iteration, so every row is predicted once per
+		// iteration instead of once per weight
+		std::vector<double> loss_derivatives(train_x.count_rows());
+		std::vector<double> row_buffer;
+
 		while (iter < max_iter)
 		{
 			loss_derivative = 0;
@@ -111,6 +116,11 @@ public:
 			// reset weight_adjustments to zero
 			std::fill(weight_adjustments.begin(), weight_adjustments.end(), 0.0);
 
+			for (size_t r = 0; r < train_x.count_rows(); ++r)
+			{
+				loss_derivatives[r] = loss_deriv(train_y(r, 0), predict(weights, train_x.row_span(r, row_buffer)));
+			}
+
 			for (size_t w = 0; w < weight_adjustments.size(); ++w)
 			{
 				for (size_t r = 0; r < train_x.count_rows(); ++r)
@@ -118,11 +128,11 @@ public:
 					// bias / intercept
 					if (w == weight_adjustments.size() - 1)
 					{
-						weight_adjustments[w] += (loss_deriv(train_y(r, 0), predict(weights, train_x.get_row(r))) * learning_rate) / train_x.count_rows();
+						weight_adjustments[w] += (loss_derivatives[r] * learning_rate) / train_x.count_rows();
 					}
 					else
 					{
-						weight_adjustments[w] += (loss_deriv(train_y(r, 0), predict(weights, train_x.get_row(r))) * learning_rate * train_x(r, w)) / train_x.count_rows();
+						weight_adjustments[w] += (loss_derivatives[r] * learning_rate * train_x(r, w)) / train_x.count_rows();
 					}
 				}
 			}
@@ -139,7 +149,7 @@ public:
 		is_fitted = true;
 	}
 
-	DataSet<size_t> predict(DataSet<double> &input_x) override
+	DataSet<size_t> predict(DataSetView<double> input_x) override
 	{
 		DataSet<size_t> prediction_data;
 
@@ -151,11 +161,12 @@ public:
 		std::vector<size_t> predictions;
 		// allocate size
 		predictions.resize(input_x.count_rows());
+		std::vector<double> row_buffer;
 
 		for (size_t current_row = 0; current_row < input_x.count_rows(); ++current_row)
 		{
 			// predict() in this case is the private function...no recursion here
-			predictions[current_row] = predict(weights, input_x.get_row(current_row));
+			predictions[current_row] = predict(weights, input_x.row_span(current_row, row_buffer));
 		}
 
 		prediction_data.resize(predictions.size(), 1);
@@ -184,7 +195,7 @@ public:
 		return weights_data;
 	}
 
-	std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
+	std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
 	{
 		return Classifier::monte_carlo_cv<LogisticRegression>(this, xdata, ydata, k, test_ratio);
 	}
@@ -27,7 +27,7 @@ class RandomForest : public Classifier {
         DataSet<size_t> selected_columns;
 
         // get the mode of an integer vec
-        int mode(std::vector<size_t> data)
+        int mode(Span<const size_t> data)
         {
             // key = data value, value = count of occurences
             std::map<size_t, size_t> mode_map;
@@ -44,7 +44,7 @@ class RandomForest : public Classifier {
     public:
         RandomForest(size_t max_column_sample = 0, size_t forest_size = 100) : max_column_sample{max_column_sample}, forest_size{forest_size} {}
 
-        void fit(DataSet<double> &data, DataSet<size_t> &target) override
+        void fit(DataSetView<double> data, DataSetView<size_t> target) override
         {
             decision_tree_vector.resize(forest_size);
 
@@ -77,22 +77,18 @@ class RandomForest : public Classifier {
                     }
                 }
 
-                // convert current data to data set in order to select relevant columns
-                DataSet<double> subset = data.select<double>(unique_column_indices);
+                // view the relevant columns of the current data
+                DataSetView<double> subset = data.select(unique_column_indices);
 
                 // resample subset with replacement to increase the variation in sample data (bootstrapping)
-                DataSet<double> resampled_subset(subset.count_rows(), subset.count_columns());
-                std::vector<size_t> resampled_target_vec;
-                size_t rand_index;
+                std::vector<size_t> resampled_rows(subset.count_rows());
                 for (size_t i = 0; i < subset.count_rows(); ++i)
                 {
-                    rand_index = rand() % subset.count_rows();
-                    resampled_subset.set_row(i, subset.get_row(rand_index));
-                    resampled_target_vec.push_back(target(rand_index, 0));
+                    resampled_rows[i] = rand() % subset.count_rows();
                 }
 
-                DataSet<size_t> resampled_target(resampled_target_vec.size(), 1);
-                resampled_target.set_column(0, resampled_target_vec);
+                DataSetView<double> resampled_subset = subset.get_rows(resampled_rows);
+                DataSetView<size_t> resampled_target = target.get_rows(resampled_rows);
 
                 decision_tree_vector[tree_n] = std::make_shared<DecisionTree>();
                 decision_tree_vector[tree_n]->fit(resampled_subset, resampled_target);
@@ -102,7 +98,7 @@ class RandomForest : public Classifier {
             }
         }
 
-        DataSet<size_t> predict(DataSet<double> &data) override
+        DataSet<size_t> predict(DataSetView<double> data) override
         {
             // iterate over stored trees and get prediction vectors
             // note that each COLUMN refers to a data point. Now we need
@@ -110,13 +106,13 @@ class RandomForest : public Classifier {
             // That way, we can iterate over each ROW and take the mode
             // for the "ensemble" prediction
 
-            DataSet<double> subset;
+            DataSetView<double> subset;
             DataSet<size_t> prediction_vector_matrix(forest_size, data.count_rows());
             DataSet<size_t> tree_predictions;
             for (size_t tree_n = 0; tree_n < forest_size; ++tree_n)
             {
                 // select the same columns from fit()
-                subset = data.select<double>(selected_columns.get_row(tree_n));
+                subset = data.select(selected_columns.get_row(tree_n));
                 tree_predictions = decision_tree_vector[tree_n]->predict(subset);
                 prediction_vector_matrix.set_row(tree_n, tree_predictions.get_column(0));
             }
@@ -130,7 +126,7 @@ class RandomForest : public Classifier {
             for (size_t i = 0; i < prediction_vector_matrix.count_rows(); ++i)
             {
                 // should probably implement this mode() in the Stats library sometime...
-                predictions.push_back(mode(prediction_vector_matrix.get_row(i)));
+                predictions.push_back(mode(prediction_vector_matrix.row_span(i)));
             }
 
             DataSet<size_t> predictions_data(predictions.size(), 1);
@@ -141,7 +137,7 @@ class RandomForest : public Classifier {
             return predictions_data;
         }
 
-        std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
+        std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<size_t> ydata, size_t k = 30, double test_ratio = 0.3)
         {
             return Classifier::monte_carlo_cv<RandomForest>(this, xdata, ydata, k, test_ratio);
         }
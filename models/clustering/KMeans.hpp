@@ -6,6 +6,7 @@
 #include <math.h>
 #include <algorithm>
 #include "../../lib/Cluster.hpp"
+#include "../../lib/Distance.hpp"
 #include "../../data/DataSet.hpp"
 class KMeans : public Cluster {
     private:
@@ -21,13 +22,6 @@ class KMeans : public Cluster {
         // used to compare with newly-assigned clusters for consistent_output_check
         std::vector<size_t> previous_clusters;
         
-        // used when computing means for new centroids
-        // key = cluster, value = data point
-        std::unordered_map<size_t, DataSet<double>> cluster_point_map;
-
-        // used to track the indices per cluster for cluster_point_map
-        std::unordered_map<size_t, size_t> cluster_point_iter;
-
         // the new "predicted" centroids per data point after completing the iteration
         // key = cluster, value = data point
         std::unordered_map<size_t, std::vector<double>> new_centroids;
@@ -41,7 +35,7 @@ class KMeans : public Cluster {
         double (*custom_distance)(std::vector<double>, std::vector<double>) = NULL;
 
         // on first iteration of fit(), randomly choose k centroids
-        void initial_clusters(DataSet<double> &data)
+        void initial_clusters(DataSetView<double> const& data)
         {
 
             srand(time(NULL));
@@ -66,26 +60,9 @@ class KMeans : public Cluster {
             }
         }
 
-        double get_distance(std::vector<double> x1, std::vector<double> x2)
+        double get_distance(Span<const double> x1, Span<const double> x2)
         {
-            if (x1.size() != x2.size())
-            {
-                throw std::invalid_argument("Mismatched sizes when trying to compute distance.");
-            }
-
-            if (has_custom_distance)
-            {
-                return custom_distance(x1, x2);
-            }
-
-            // Euclidean distance (default)
-            double distance = 0;
-            for (int i = 0; i < x1.size(); ++i)
-            {
-                distance += (x1[i] - x2[i]) * (x1[i] - x2[i]);
-            }
-
-            return sqrt(distance);
+            return row_distance(x1, x2, has_custom_distance ? custom_distance : NULL);
         }
 
     public:
@@ -100,7 +77,7 @@ class KMeans : public Cluster {
         }
 
         size_t argmin_index;
-        void fit(DataSet<double> &data) override
+        void fit(DataSetView<double> data) override
         {
             // generate random centroids
             if (!this->initial_clusters_created)
@@ -111,20 +88,26 @@ class KMeans : public Cluster {
 
             if (assigned_clusters.size() > 0) { previous_clusters = assigned_clusters; }
             assigned_clusters.clear();
+
+            // only used if the view doesn't keep its rows contiguous
+            std::vector<double> point_buffer, centroid_buffer;
+
             // iterate over data and find closest centroid
             for (size_t i = 0; i < data.count_rows(); ++i)
             {
+                Span<const double> point = data.row_span(i, point_buffer);
+
                 // check distance to each centroid
                 distance_vec.clear();
                 for (size_t c = 0; c < this->k; ++c)
                 {
                     if (!computed_centroids) // if first iteration
                     {
-                        distance_vec.push_back(get_distance(data.get_row(i), data.get_row(centroid_index_vec[c])));
+                        distance_vec.push_back(get_distance(point, data.row_span(centroid_index_vec[c], centroid_buffer)));
                     }
                     else // all other iterations (after centroids are computed via means)
                     {
-                        distance_vec.push_back(get_distance(data.get_row(i), new_centroids[c]));
+                        distance_vec.push_back(get_distance(point, new_centroids[c]));
                     }
                 }
                 argmin_index = std::distance(distance_vec.begin(), std::min_element(distance_vec.begin(), distance_vec.end()));
@@ -137,52 +120,31 @@ class KMeans : public Cluster {
                 return;
             }
 
-            // partition data on newly-assigned clusters
-            size_t get_cluster;
-            cluster_point_map.clear();
-            // count the data points per cluster to size up cluster_point_map
-            std::unordered_map<size_t, size_t> cluster_counts;
-            for (size_t cluster : assigned_clusters)
-            {
-                cluster_counts[cluster]++;
-            }
-
-            // initialize cluster iterators to zero
-            // size up cluster_point_map
-            cluster_point_iter.clear();
-            for (size_t i = 0; i < this->k; ++i)
-            {
-                cluster_point_iter[i] = 0;
-                cluster_point_map[i] = DataSet<double>(cluster_counts[i], data.count_columns());
-            }
-
-
+            // sum up the points of each newly-assigned cluster (in row order) instead of copying them out
+            size_t columns = data.count_columns();
+            std::vector<std::vector<double>> cluster_sums(this->k, std::vector<double>(columns, 0.0));
+            std::vector<size_t> cluster_counts(this->k, 0);
             for (size_t i = 0; i < data.count_rows(); ++i)
             {
-                get_cluster = assigned_clusters[i];
-                cluster_point_map[get_cluster].set_row(cluster_point_iter[get_cluster], data.get_row(i));
-                cluster_point_iter[get_cluster]++;
+                Span<const double> point = data.row_span(i, point_buffer);
+                std::vector<double> &sums = cluster_sums[assigned_clusters[i]];
+                for (size_t col = 0; col < columns; ++col)
+                {
+                    sums[col] += point[col];
+                }
+                cluster_counts[assigned_clusters[i]]++;
             }
 
-            // take partitioned data and compute means
-            std::vector<double> new_computed_centroid;
-            double sum;
+            // compute means
             new_centroids.clear();
             for (size_t c = 0; c < this->k; ++c)
             {
-                new_computed_centroid.clear();
-                sum = 0;
-                for (size_t col = 0; col < cluster_point_map[c].count_columns(); ++col)
+                for (size_t col = 0; col < columns; ++col)
                 {
-                    for (size_t row = 0; row < cluster_point_map[c].count_rows(); ++row)
-                    {
-                        sum += cluster_point_map[c](row, col);
-                    }
-                    new_computed_centroid.push_back(sum / cluster_point_map[c].count_rows());
-                    sum = 0;
+                    cluster_sums[c][col] /= cluster_counts[c];
                 }
                 // add new computed centroid
-                new_centroids[c] = new_computed_centroid;
+                new_centroids[c] = std::move(cluster_sums[c]);
             }
             // new centroids have been computed via means
             this->computed_centroids = true;
@@ -195,7 +157,7 @@ class KMeans : public Cluster {
 
         }
 
-        DataSet<size_t> predict(DataSet<double> &data)
+        DataSet<size_t> predict(DataSetView<double> data) override
         {
             if (new_centroids.size() == 0)
             {
@@ -204,14 +166,17 @@ class KMeans : public Cluster {
 
             std::vector<double> distance;
             std::vector<size_t> predicted_clusters;
+            std::vector<double> point_buffer;
             // iterate over data and find closest centroid
             for (size_t i = 0; i < data.count_rows(); ++i)
             {
+                Span<const double> point = data.row_span(i, point_buffer);
+
                 // check distance to each centroid
                 distance.clear();
                 for (size_t c = 0; c < this->k; ++c)
                 {
-                    distance.push_back(get_distance(data.get_row(i), new_centroids[c]));
+                    distance.push_back(get_distance(point, new_centroids[c]));
 
                 }
                 argmin_index = std::distance(distance.begin(), std::min_element(distance.begin(), distance.end()));
@@ -52,7 +52,7 @@ private:
 	}
 
 	// local predict, not to be confused with the public predict()
-	double predict(std::vector<double> &weights, std::vector<double> input_x_row)
+	double predict(std::vector<double> &weights, Span<const double> input_x_row)
 	{
 
 		double result = 0;
@@ -79,9 +79,9 @@ public:
 		if (loss_func != NULL) { user_loss_func = loss_func; }
 	}
 
-	void fit(DataSet<double> &train_x, DataSet<double> &train_y) override
+	void fit(DataSetView<double> train_x, DataSetView<double> train_y) override
 	{
-		this->independent_variable_names = train_x.column_names;
+		this->independent_variable_names = train_x.get_column_names();
 
 		// create initial weights equal to size of input columns (# of indep vars)
 		for (size_t col = 0; col < train_x.count_columns(); ++col)
@@ -97,6 +97,11 @@ public:
 		size_t iter = 0;
 		double prediction, loss_derivative;
 
+		// the weights only change at the end of an iteration, so every row is predicted once per
+		// iteration instead of once per weight
+		std::vector<double> loss_derivatives(train_x.count_rows());
+		std::vector<double> row_buffer;
+
 		while (iter < max_iter)
 		{
 			loss_derivative = 0;
@@ -104,6 +109,11 @@ public:
 			// reset weight_adjustments to zero
 			std::fill(weight_adjustments.begin(), weight_adjustments.end(), 0.0);
 
+			for (size_t r = 0; r < train_x.count_rows(); ++r)
+			{
+				loss_derivatives[r] = loss_deriv(train_y(r, 0), predict(weights, train_x.row_span(r, row_buffer)));
+			}
+
 			for (size_t w = 0; w < weight_adjustments.size(); ++w)
 			{
 				for (size_t r = 0; r < train_x.count_rows(); ++r)
@@ -111,11 +121,11 @@ public:
 					// bias / intercept
 					if (w == weight_adjustments.size() - 1)
 					{
-						weight_adjustments[w] += (loss_deriv(train_y(r, 0), predict(weights, train_x.get_row(r))) * learning_rate) / train_x.count_rows();
+						weight_adjustments[w] += (loss_derivatives[r] * learning_rate) / train_x.count_rows();
 					}
 					else
 					{
-						weight_adjustments[w] += (loss_deriv(train_y(r, 0), predict(weights, train_x.get_row(r))) * learning_rate * train_x(r, w)) / train_x.count_rows();
+						weight_adjustments[w] += (loss_derivatives[r] * learning_rate * train_x(r, w)) / train_x.count_rows();
 					}
 				}
 			}
@@ -132,7 +142,7 @@ public:
 		is_fitted = true;
 	}
 
-	DataSet<double> predict(DataSet<double> &input_x) override
+	DataSet<double> predict(DataSetView<double> input_x) override
 	{
 		DataSet<double> prediction_data;
 
@@ -144,11 +154,12 @@ public:
 		std::vector<double> predictions;
 		// allocate size
 		predictions.resize(input_x.count_rows());
+		std::vector<double> row_buffer;
 
 		for (size_t current_row = 0; current_row < input_x.count_rows(); ++current_row)
 		{
 			// predict() in this case is the private function...no recursion here
-			predictions[current_row] = predict(weights, input_x.get_row(current_row));
+			predictions[current_row] = predict(weights, input_x.row_span(current_row, row_buffer));
 		}
 
 		prediction_data.resize(predictions.size(), 1);
@@ -177,7 +188,7 @@ public:
 		return weights_data;
 	}
 
-	std::vector<double> monte_carlo_cv(DataSet<double> xdata, DataSet<double> ydata, size_t k = 30, double test_ratio = 0.3)
+	std::vector<double> monte_carlo_cv(DataSetView<double> xdata, DataSetView<double> ydata, size_t k = 30, double test_ratio = 0.3)
 	{
 		return Regressor::monte_carlo_cv<LinearRegression>(this, xdata, ydata, k, test_ratio);
 	}